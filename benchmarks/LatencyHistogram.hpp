@@ -0,0 +1,165 @@
+#pragma once
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// HDR-style latency histogram for benchmarks.
+//
+// Values below 2^sub_bucket_bits are counted exactly; above that, every
+// power of two is split into 2^sub_bucket_bits linear buckets, so any
+// recorded value is known to within 1/128 of itself whatever its
+// magnitude. Recording is a couple of bit operations and an increment, so
+// it can run inside the timed loop without pushing the percentiles up.
+//
+// Latencies are taken with steady_clock around each operation; the clock
+// read itself (some tens of ns) is part of every sample, so compare
+// allocators against each other rather than against zero.
+
+class LatencyHistogram {
+public:
+    using Clock = std::chrono::steady_clock;
+
+private:
+    static constexpr unsigned sub_bucket_bits = 7;
+    static constexpr uint64_t sub_buckets = uint64_t{1} << sub_bucket_bits;
+    static constexpr size_t bucket_count = (64 - sub_bucket_bits + 1) * sub_buckets;
+
+    std::vector<uint64_t> counts_;
+    uint64_t total_ = 0;
+    uint64_t min_ = UINT64_MAX;
+    uint64_t max_ = 0;
+    double sum_ = 0;
+
+    static size_t index_of(uint64_t value) noexcept {
+        if (value < sub_buckets)
+            return static_cast<size_t>(value);
+
+        unsigned shift = static_cast<unsigned>(std::bit_width(value)) - 1 - sub_bucket_bits;
+        return static_cast<size_t>(shift * sub_buckets + (value >> shift));
+    }
+
+    // Largest value that lands in the bucket
+    static uint64_t upper_bound(size_t index) noexcept {
+        if (index < 2 * sub_buckets)
+            return index;
+
+        unsigned shift = static_cast<unsigned>(index / sub_buckets) - 1;
+        uint64_t mantissa = index - shift * sub_buckets;
+        return ((mantissa + 1) << shift) - 1;
+    }
+
+public:
+    LatencyHistogram() : counts_(bucket_count, 0) {}
+
+    void record(uint64_t nanoseconds) noexcept {
+        ++counts_[index_of(nanoseconds)];
+        ++total_;
+        min_ = std::min(min_, nanoseconds);
+        max_ = std::max(max_, nanoseconds);
+        sum_ += static_cast<double>(nanoseconds);
+    }
+
+    // Time a callable and record how long it took
+    template<typename F>
+    void time(F&& operation) {
+        auto start = Clock::now();
+        operation();
+        auto stop = Clock::now();
+        record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count()));
+    }
+
+    void merge(const LatencyHistogram& other) noexcept {
+        for (size_t i = 0; i < bucket_count; ++i)
+            counts_[i] += other.counts_[i];
+        total_ += other.total_;
+        min_ = std::min(min_, other.min_);
+        max_ = std::max(max_, other.max_);
+        sum_ += other.sum_;
+    }
+
+    void clear() noexcept {
+        std::fill(counts_.begin(), counts_.end(), 0);
+        total_ = 0;
+        min_ = UINT64_MAX;
+        max_ = 0;
+        sum_ = 0;
+    }
+
+    uint64_t count() const noexcept { return total_; }
+    uint64_t min() const noexcept { return total_ != 0 ? min_ : 0; }
+    uint64_t max() const noexcept { return max_; }
+    double mean() const noexcept { return total_ != 0 ? sum_ / static_cast<double>(total_) : 0.0; }
+
+    // Smallest recorded value (to bucket precision) that percent% of samples do not exceed
+    uint64_t percentile(double percent) const noexcept {
+        if (total_ == 0)
+            return 0;
+
+        uint64_t target = static_cast<uint64_t>(std::ceil(percent / 100.0 * static_cast<double>(total_)));
+        target = std::clamp<uint64_t>(target, 1, total_);
+
+        uint64_t seen = 0;
+        for (size_t i = 0; i < bucket_count; ++i) {
+            seen += counts_[i];
+            if (seen >= target)
+                return std::min(upper_bound(i), max_);
+        }
+        return max_;
+    }
+
+    // Add p50/p99/p99.9/max (and mean) to the benchmark's counters
+    void report(benchmark::State& state, const std::string& prefix = "") const {
+        state.counters[prefix + "p50_ns"] = static_cast<double>(percentile(50.0));
+        state.counters[prefix + "p99_ns"] = static_cast<double>(percentile(99.0));
+        state.counters[prefix + "p99.9_ns"] = static_cast<double>(percentile(99.9));
+        state.counters[prefix + "max_ns"] = static_cast<double>(max());
+        state.counters[prefix + "mean_ns"] = mean();
+    }
+};
+
+// One histogram per benchmark thread, merged and reported by thread 0.
+//
+// Google Benchmark holds every thread at a barrier when the timed loop
+// starts and again when it ends, so local() is called before the loop and
+// report() after it without further synchronisation. Only thread 0 sets
+// counters; the other threads contribute nothing to the summed values.
+class ThreadLatencies {
+private:
+    std::mutex mutex_;
+    std::vector<std::unique_ptr<LatencyHistogram>> slots_;
+
+public:
+    // The calling thread's histogram, cleared
+    LatencyHistogram& local(const benchmark::State& state) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        size_t index = static_cast<size_t>(state.thread_index());
+        if (slots_.size() <= index)
+            slots_.resize(index + 1);
+        if (!slots_[index])
+            slots_[index] = std::make_unique<LatencyHistogram>();
+
+        slots_[index]->clear();
+        return *slots_[index];
+    }
+
+    void report(benchmark::State& state, const std::string& prefix = "") {
+        if (state.thread_index() != 0)
+            return;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        LatencyHistogram merged;
+        size_t threads = std::min(static_cast<size_t>(state.threads()), slots_.size());
+        for (size_t i = 0; i < threads; ++i)
+            merged.merge(*slots_[i]);
+        merged.report(state, prefix);
+    }
+};
@@ -0,0 +1,167 @@
+#pragma once
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#if defined(__linux__)
+    #include <linux/perf_event.h>
+    #include <sys/ioctl.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
+// Hardware counters for benchmarks through perf_event_open (Linux only).
+//
+// Each counter is opened separately, so events the CPU or the container does
+// not support are simply missing from the report rather than failing the
+// group. Counters are reported per iteration as Google Benchmark user
+// counters. Set ARENAX_PERF=0 to skip them, e.g. when the PMU is shared.
+//
+// With more events than hardware counters the kernel multiplexes them, so
+// each one only counts for part of the run. Every count is read together
+// with its enabled and running times and scaled by enabled / running; an
+// event that was never scheduled is reported as <name>_not_counted = 1
+// instead of as zero.
+//
+// Typical use:
+//
+//     PerfCounters perf;
+//     perf.start();
+//     for (auto _ : state) { ... }
+//     perf.stop();
+//     perf.report(state);
+
+struct PerfEvent {
+    const char* name;
+    uint32_t type;
+    uint64_t config;
+};
+
+#if defined(__linux__)
+constexpr uint64_t perf_cache_miss(uint64_t cache, uint64_t op) {
+    return cache | (op << 8) | (uint64_t{PERF_COUNT_HW_CACHE_RESULT_MISS} << 16);
+}
+
+// cycles and instructions come first: report() derives IPC from them
+inline constexpr std::array<PerfEvent, 6> perf_events = {{
+    {"cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {"instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {"L1d_misses", PERF_TYPE_HW_CACHE, perf_cache_miss(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ)},
+    {"LLC_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {"dTLB_misses", PERF_TYPE_HW_CACHE, perf_cache_miss(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_OP_READ)},
+    {"page_faults", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS},
+}};
+#else
+inline constexpr std::array<PerfEvent, 0> perf_events = {};
+#endif
+
+class PerfCounters {
+private:
+    static constexpr auto& events = perf_events;
+
+    std::array<int, events.size()> fds_;
+    std::array<double, events.size()> values_;
+    std::array<bool, events.size()> counted_;
+
+public:
+    PerfCounters() noexcept {
+        fds_.fill(-1);
+        values_.fill(0);
+        counted_.fill(false);
+
+        const char* env = std::getenv("ARENAX_PERF");
+        if (env != nullptr && std::strcmp(env, "0") == 0)
+            return;
+
+#if defined(__linux__)
+        for (size_t i = 0; i < events.size(); ++i) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = events[i].type;
+            attr.config = events[i].config;
+            attr.disabled = 1;
+            attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            attr.exclude_kernel = 1;        // allowed with perf_event_paranoid <= 2
+            attr.exclude_hv = 1;
+
+            // Page faults are taken in the kernel on our behalf; count them there
+            if (events[i].type == PERF_TYPE_SOFTWARE)
+                attr.exclude_kernel = 0;
+
+            fds_[i] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+        }
+#endif
+    }
+
+    ~PerfCounters() {
+#if defined(__linux__)
+        for (int fd : fds_) {
+            if (fd >= 0)
+                close(fd);
+        }
+#endif
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    // Whether at least one counter could be opened
+    bool available() const noexcept {
+        for (int fd : fds_) {
+            if (fd >= 0)
+                return true;
+        }
+        return false;
+    }
+
+    void start() noexcept {
+#if defined(__linux__)
+        for (int fd : fds_) {
+            if (fd >= 0) {
+                ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+#endif
+    }
+
+    void stop() noexcept {
+#if defined(__linux__)
+        for (size_t i = 0; i < fds_.size(); ++i) {
+            if (fds_[i] < 0)
+                continue;
+            ioctl(fds_[i], PERF_EVENT_IOC_DISABLE, 0);
+
+            // value, time enabled, time running
+            uint64_t data[3] = {};
+            values_[i] = 0;
+            counted_[i] = read(fds_[i], data, sizeof(data)) == static_cast<ssize_t>(sizeof(data)) && data[2] != 0;
+            if (counted_[i])
+                values_[i] = static_cast<double>(data[0]) * static_cast<double>(data[1]) / static_cast<double>(data[2]);
+        }
+#endif
+    }
+
+    // Add the counters read by stop() to the benchmark, averaged per iteration
+    void report(benchmark::State& state) const {
+        for (size_t i = 0; i < fds_.size(); ++i) {
+            if (fds_[i] < 0)
+                continue;
+            if (counted_[i])
+                state.counters[events[i].name] = benchmark::Counter(values_[i], benchmark::Counter::kAvgIterations);
+            else
+                state.counters[std::string(events[i].name) + "_not_counted"] = 1;
+        }
+
+        if constexpr (events.size() >= 2) {
+            if (counted_[0] && counted_[1] && values_[0] > 0)
+                state.counters["IPC"] = values_[1] / values_[0];
+        }
+    }
+};
@@ -0,0 +1,212 @@
+#include <benchmark/benchmark.h>
+#include "PerfCounters.hpp"
+#include "quanta/Arena.hpp"
+#include "quanta/BuddyAllocator.hpp"
+#include "quanta/GrowingArena.hpp"
+#include "quanta/TlsfAllocator.hpp"
+
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using namespace quanta;
+
+// Allocator x workload matrix with hardware counters next to wall time, to
+// show why an allocator wins or loses (instructions, cache and TLB misses,
+// page faults) and not just by how much.
+
+namespace {
+
+constexpr size_t region_size = 64 << 20;
+
+// Common interface: allocate, release everything allocated so far, and
+// reserve room to remember that many allocations. Every workload calls
+// reserve() before timing starts, so adapters that must track pointers
+// never grow their list inside the timed loop.
+struct MallocAdapter {
+    std::vector<void*> live;
+
+    void reserve(size_t allocations) { live.reserve(allocations); }
+
+    void* allocate(size_t size, size_t) noexcept {
+        void* p = std::malloc(size);
+        live.push_back(p);
+        return p;
+    }
+
+    void release() noexcept {
+        for (void* p : live)
+            std::free(p);
+        live.clear();
+    }
+};
+
+struct ArenaAdapter {
+    Arena arena{region_size};
+
+    void reserve(size_t) {}
+    void* allocate(size_t size, size_t alignment) noexcept { return arena.allocate(size, alignment); }
+    void release() noexcept { arena.reset(); }
+};
+
+struct GrowingArenaAdapter {
+    GrowingArena arena{64 << 10};
+
+    void reserve(size_t) {}
+    void* allocate(size_t size, size_t alignment) noexcept { return arena.allocate(size, alignment); }
+    void release() noexcept { arena.reset(); }
+};
+
+struct TlsfAdapter {
+    Arena backing{region_size + (1 << 20)};
+    TlsfAllocator tlsf{backing, region_size};
+    std::vector<void*> live;
+
+    void reserve(size_t allocations) { live.reserve(allocations); }
+
+    void* allocate(size_t size, size_t alignment) noexcept {
+        void* p = tlsf.allocate(size, alignment);
+        live.push_back(p);
+        return p;
+    }
+
+    void release() noexcept {
+        for (void* p : live)
+            tlsf.deallocate(p);
+        live.clear();
+    }
+};
+
+struct BuddyAdapter {
+    Arena backing{2 * region_size};
+    BuddyAllocator buddy{backing, region_size, 16};
+    std::vector<void*> live;
+
+    void reserve(size_t allocations) { live.reserve(allocations); }
+
+    void* allocate(size_t size, size_t alignment) noexcept {
+        void* p = buddy.allocate(size, alignment);
+        live.push_back(p);
+        return p;
+    }
+
+    void release() noexcept {
+        for (void* p : live)
+            buddy.deallocate(p);
+        live.clear();
+    }
+};
+
+struct Node {
+    Node* next;
+    uint64_t value;
+    char payload[48];
+};
+
+// Many small short-lived objects, released together
+template<typename Adapter>
+void BM_SmallObjects(benchmark::State& state) {
+    Adapter allocator;
+    PerfCounters perf;
+    const size_t count = static_cast<size_t>(state.range(0));
+    allocator.reserve(count);
+
+    perf.start();
+    for (auto _ : state) {
+        for (size_t i = 0; i < count; ++i) {
+            void* p = allocator.allocate(32, 8);
+            benchmark::DoNotOptimize(p);
+        }
+        allocator.release();
+    }
+    perf.stop();
+
+    perf.report(state);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * count));
+}
+
+// Build a linked list with unrelated allocations interleaved, then walk it:
+// how tightly the allocator packs the nodes shows up as cache and TLB
+// misses in the walk
+template<typename Adapter>
+void BM_LinkedListWalk(benchmark::State& state) {
+    Adapter allocator;
+    PerfCounters perf;
+    const size_t count = static_cast<size_t>(state.range(0));
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<size_t> noise_size(16, 256);
+    std::vector<size_t> noise(count);
+    for (size_t& s : noise)
+        s = noise_size(rng);
+    allocator.reserve(2 * count);
+
+    perf.start();
+    for (auto _ : state) {
+        Node* head = nullptr;
+        Node** tail = &head;
+        for (size_t i = 0; i < count; ++i) {
+            Node* n = static_cast<Node*>(allocator.allocate(sizeof(Node), alignof(Node)));
+            n->next = nullptr;
+            n->value = i;
+            *tail = n;
+            tail = &n->next;
+
+            benchmark::DoNotOptimize(allocator.allocate(noise[i], 8));
+        }
+
+        uint64_t sum = 0;
+        for (int pass = 0; pass < 4; ++pass) {
+            for (Node* n = head; n != nullptr; n = n->next)
+                sum += n->value;
+        }
+        benchmark::DoNotOptimize(sum);
+        allocator.release();
+    }
+    perf.stop();
+
+    perf.report(state);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * count));
+}
+
+// Mixed sizes, each touched at both ends, released together
+template<typename Adapter>
+void BM_MixedSizes(benchmark::State& state) {
+    Adapter allocator;
+    PerfCounters perf;
+    const size_t count = static_cast<size_t>(state.range(0));
+
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<size_t> size(8, 1024);
+    std::vector<size_t> sizes(count);
+    for (size_t& s : sizes)
+        s = size(rng);
+    allocator.reserve(count);
+
+    perf.start();
+    for (auto _ : state) {
+        for (size_t s : sizes) {
+            char* p = static_cast<char*>(allocator.allocate(s, 8));
+            p[0] = 1;
+            p[s - 1] = 1;
+        }
+        allocator.release();
+    }
+    perf.stop();
+
+    perf.report(state);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * count));
+}
+
+} // namespace
+
+#define ARENAX_ALLOCATOR_BENCHMARKS(workload, arg)                            \
+    BENCHMARK_TEMPLATE(workload, MallocAdapter)->Arg(arg);                     \
+    BENCHMARK_TEMPLATE(workload, ArenaAdapter)->Arg(arg);                      \
+    BENCHMARK_TEMPLATE(workload, GrowingArenaAdapter)->Arg(arg);               \
+    BENCHMARK_TEMPLATE(workload, TlsfAdapter)->Arg(arg);                       \
+    BENCHMARK_TEMPLATE(workload, BuddyAdapter)->Arg(arg)
+
+ARENAX_ALLOCATOR_BENCHMARKS(BM_SmallObjects, 4096);
+ARENAX_ALLOCATOR_BENCHMARKS(BM_LinkedListWalk, 100000);
+ARENAX_ALLOCATOR_BENCHMARKS(BM_MixedSizes, 10000);
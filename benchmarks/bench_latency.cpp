@@ -0,0 +1,224 @@
+#include <benchmark/benchmark.h>
+#include "LatencyHistogram.hpp"
+#include "quanta/Arena.hpp"
+#include "quanta/ArenaPool.hpp"
+#include "quanta/GrowingArena.hpp"
+#include "quanta/SharedPool.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace quanta;
+
+// Per-operation latency distributions. Throughput numbers average away the
+// pauses that matter: a GrowingArena chaining a new block, the first touch
+// of a fresh page, an ArenaPool re-warming an arena after trim(). Every
+// benchmark records each operation into an HDR histogram and reports
+// p50/p99/p99.9/max, single-threaded and with one thread per core.
+
+namespace {
+
+const int max_threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+
+constexpr size_t min_size = 16;
+constexpr size_t max_size = 256;
+
+std::vector<size_t> make_sizes(size_t count, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<size_t> size(min_size, max_size);
+
+    std::vector<size_t> sizes(count);
+    for (size_t& s : sizes)
+        s = size(rng);
+    return sizes;
+}
+
+// ALLOCATE
+// Each thread owns its arena; the timed operation is allocate plus the
+// first write to the block, so page faults on first touch are included.
+// The arena is reset, untimed, after a fixed number of allocations.
+
+struct ArenaAdapter {
+    Arena arena{64 << 20};
+
+    void* allocate(size_t size) noexcept { return arena.allocate(size, 8); }
+    void reset() noexcept { arena.reset(); }
+};
+
+struct GrowingArenaAdapter {
+    GrowingArena arena{64 << 10};
+
+    void* allocate(size_t size) noexcept { return arena.allocate(size, 8); }
+    void reset() noexcept { arena.reset(); }
+};
+
+template<typename Adapter>
+void BM_Allocate(benchmark::State& state) {
+    static ThreadLatencies latencies;
+
+    constexpr size_t cycle = 1 << 16;                   // allocations between resets, ~9 MiB
+    auto allocator = std::make_unique<Adapter>();
+    std::vector<size_t> sizes = make_sizes(cycle, 1234 + static_cast<unsigned>(state.thread_index()));
+    LatencyHistogram& histogram = latencies.local(state);
+
+    size_t next = 0;
+    for (auto _ : state) {
+        histogram.time([&] {
+            char* p = static_cast<char*>(allocator->allocate(sizes[next]));
+            p[0] = 1;
+            benchmark::DoNotOptimize(p);
+        });
+
+        if (++next == cycle) {
+            next = 0;
+            allocator->reset();
+        }
+    }
+
+    latencies.report(state);
+    state.SetItemsProcessed(state.iterations());
+}
+
+// POOL ALLOCATE/FREE
+// One pool shared by every thread. Each thread keeps a ring of live blocks;
+// the timed operation frees the oldest and allocates a replacement.
+
+constexpr size_t ring_size = 64;
+constexpr size_t pool_block = 64;
+
+struct MallocPool {
+    void* allocate() noexcept { return std::malloc(pool_block); }
+    void deallocate(void* p) noexcept { std::free(p); }
+};
+
+struct SharedPoolAdapter {
+    SharedPool pool = SharedPool::create_anonymous(pool_block, ring_size * 1024);
+
+    void* allocate() noexcept { return pool.allocate(); }
+    void deallocate(void* p) noexcept { pool.deallocate(p); }
+};
+
+template<typename Pool>
+void BM_PoolAllocFree(benchmark::State& state) {
+    static ThreadLatencies latencies;
+    static std::unique_ptr<Pool> pool;
+
+    // Other threads wait at the start of the loop until thread 0 is done here
+    if (state.thread_index() == 0)
+        pool = std::make_unique<Pool>();
+
+    LatencyHistogram& histogram = latencies.local(state);
+    std::vector<void*> ring(ring_size, nullptr);
+    size_t next = 0;
+
+    for (auto _ : state) {
+        void*& slot = ring[next];
+        next = (next + 1) % ring_size;
+
+        histogram.time([&] {
+            if (slot != nullptr)
+                pool->deallocate(slot);
+            slot = pool->allocate();
+        });
+        benchmark::DoNotOptimize(slot);
+    }
+
+    for (void* p : ring) {
+        if (p != nullptr)
+            pool->deallocate(p);
+    }
+
+    latencies.report(state);
+    state.SetItemsProcessed(state.iterations());
+}
+
+// ARENA POOL CHECKOUT
+// Check out an arena, use a little of it, hand it back. With a trim
+// interval, thread 0 releases every idle arena that often, so later
+// checkouts pay for re-creating and pre-faulting one. Only successful
+// checkouts go into the histogram; a failed acquire returns early and
+// would pull the percentiles down, so failures are counted separately.
+
+constexpr size_t lease_capacity = 256 << 10;
+
+void BM_ArenaPoolCheckout(benchmark::State& state) {
+    static ThreadLatencies latencies;
+    static std::unique_ptr<ArenaPool> pool;
+
+    const size_t trim_every = static_cast<size_t>(state.range(0));
+    if (state.thread_index() == 0)
+        pool = std::make_unique<ArenaPool>(std::initializer_list<ArenaPool::BucketConfig>{
+            {lease_capacity, static_cast<size_t>(state.threads()) * 2}});
+
+    LatencyHistogram& histogram = latencies.local(state);
+    size_t ops = 0;
+    size_t failures = 0;
+
+    for (auto _ : state) {
+        auto start = LatencyHistogram::Clock::now();
+        {
+            ArenaPool::Lease lease = pool->acquire(lease_capacity);
+            if (!lease) {
+                ++failures;
+                continue;
+            }
+            char* p = static_cast<char*>(lease->allocate(1024, 8));
+            p[0] = 1;
+            benchmark::DoNotOptimize(p);
+        }
+        auto stop = LatencyHistogram::Clock::now();
+        histogram.record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count()));
+
+        if (trim_every != 0 && state.thread_index() == 0 && ++ops % trim_every == 0)
+            pool->trim(std::chrono::nanoseconds(0));
+    }
+
+    latencies.report(state);
+    state.counters["failures"] = static_cast<double>(failures);     // summed over threads
+    state.SetItemsProcessed(state.iterations());
+}
+
+// RESET
+// Fill a per-thread arena (untimed), then time the reset. GrowingArena
+// frees every block but the first here, so this is where it pays.
+
+template<typename Adapter>
+void BM_ResetCycle(benchmark::State& state) {
+    static ThreadLatencies latencies;
+
+    const size_t fill = static_cast<size_t>(state.range(0));
+    auto allocator = std::make_unique<Adapter>();
+    std::vector<size_t> sizes = make_sizes(fill, 99 + static_cast<unsigned>(state.thread_index()));
+    LatencyHistogram& histogram = latencies.local(state);
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        for (size_t s : sizes)
+            static_cast<char*>(allocator->allocate(s))[0] = 1;
+        state.ResumeTiming();
+
+        histogram.time([&] { allocator->reset(); });
+    }
+
+    latencies.report(state);
+    state.SetItemsProcessed(state.iterations());
+}
+
+} // namespace
+
+BENCHMARK_TEMPLATE(BM_Allocate, ArenaAdapter)->ThreadRange(1, max_threads)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_Allocate, GrowingArenaAdapter)->ThreadRange(1, max_threads)->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_PoolAllocFree, MallocPool)->ThreadRange(1, max_threads)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_PoolAllocFree, SharedPoolAdapter)->ThreadRange(1, max_threads)->UseRealTime();
+
+// Arg: checkouts between trims by thread 0 (0 = never trim)
+BENCHMARK(BM_ArenaPoolCheckout)->Arg(0)->Arg(1024)->ThreadRange(1, max_threads)->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_ResetCycle, ArenaAdapter)->Arg(16384)->ThreadRange(1, max_threads)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ResetCycle, GrowingArenaAdapter)->Arg(16384)->ThreadRange(1, max_threads)->UseRealTime();
@@ -0,0 +1,387 @@
+#include <benchmark/benchmark.h>
+#include "quanta/ArenaPool.hpp"
+#include "quanta/SharedArena.hpp"
+#include "quanta/SharedPool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+using namespace quanta;
+
+// Throughput of the thread-safe allocators from 1 to hardware_concurrency
+// threads, under three traffic shapes:
+//
+//  AllLocal       every thread allocates and frees its own blocks
+//  CrossThread    every thread frees blocks allocated by its neighbour
+//                 (blocks that find the neighbour's queue full are freed
+//                 locally and counted as "spilled"; many spills mean the
+//                 threads were not really running side by side)
+//  ProducerConsumer  half the threads allocate, the other half free
+//
+// Besides ops/sec, each run reports its efficiency: throughput divided by
+// (threads x single-thread throughput) of the same allocator and workload.
+// 1.0 is perfect scaling; where it drops off is where contention begins.
+//
+// Every thread runs the same fixed number of operations so that the
+// SharedArena, which cannot reset while other threads allocate, is sized
+// up front for the whole run. Throughput is measured on one wall clock
+// from the first thread starting to the last one finishing.
+
+namespace {
+
+const int max_threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+
+constexpr size_t block_size = 32;
+constexpr int64_t ops_per_thread = 1 << 19;
+constexpr size_t queue_capacity = 256;
+constexpr size_t local_batch = 64;
+
+// Bounded single-producer single-consumer queue handing blocks between threads
+template<typename T>
+class SpscQueue {
+private:
+    std::unique_ptr<T[]> items_;
+    alignas(64) std::atomic<size_t> head_{0};       // next pop
+    alignas(64) std::atomic<size_t> tail_{0};       // next push
+
+public:
+    SpscQueue() : items_(std::make_unique<T[]>(queue_capacity)) {}
+
+    bool push(T& item) noexcept {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) == queue_capacity)
+            return false;
+        items_[tail % queue_capacity] = std::move(item);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T& item) noexcept {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire))
+            return false;
+        item = std::move(items_[head % queue_capacity]);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+};
+
+// ADAPTERS
+// One instance is shared by every thread of a run. Item is what travels
+// between threads; an empty Item means the allocator was exhausted.
+
+struct MallocAdapter {
+    using Item = void*;
+    static constexpr const char* name = "malloc";
+
+    explicit MallocAdapter(int) {}
+    Item allocate() noexcept { return std::malloc(block_size); }
+    void deallocate(Item& p) noexcept { std::free(p); }
+};
+
+// Concurrent bump allocation; blocks are only reclaimed by reset(), so
+// deallocate() is free and the arena holds every block of the run
+struct SharedArenaAdapter {
+    using Item = void*;
+    static constexpr const char* name = "SharedArena";
+    SharedArena arena;
+
+    explicit SharedArenaAdapter(int threads)
+        : arena(SharedArena::create_anonymous(static_cast<size_t>(threads) * ops_per_thread * block_size + (1 << 20))) {}
+
+    Item allocate() noexcept { return arena.allocate(block_size, 16); }
+    void deallocate(Item&) noexcept {}
+};
+
+struct SharedPoolAdapter {
+    using Item = void*;
+    static constexpr const char* name = "SharedPool";
+    SharedPool pool;
+
+    // Every block can be in flight at once: the thread's own batch plus a full queue
+    explicit SharedPoolAdapter(int threads)
+        : pool(SharedPool::create_anonymous(block_size, static_cast<size_t>(threads) * (queue_capacity + local_batch + 1))) {}
+
+    Item allocate() noexcept { return pool.allocate(); }
+    void deallocate(Item& p) noexcept { pool.deallocate(p); }
+};
+
+// Whole arenas handed out and returned, the coarse-grained pooling pattern
+struct ArenaPoolAdapter {
+    using Item = ArenaPool::Lease;
+    static constexpr const char* name = "ArenaPool";
+    ArenaPool pool;
+
+    explicit ArenaPoolAdapter(int threads)
+        : pool({{4096, static_cast<size_t>(threads) * (queue_capacity + local_batch + 1)}}) {}
+
+    Item allocate() noexcept {
+        Item lease = pool.acquire(4096);
+        if (lease)
+            benchmark::DoNotOptimize(lease->allocate(block_size, 8));
+        return lease;
+    }
+
+    void deallocate(Item& lease) noexcept { lease.release(); }
+};
+
+template<typename Item>
+bool is_empty(const Item& item) {
+    if constexpr (std::is_pointer_v<Item>)
+        return item == nullptr;
+    else
+        return !item;
+}
+
+// EFFICIENCY
+// Single-thread throughput per benchmark family, recorded by the
+// threads:1 run, which ThreadRange schedules first.
+
+void report_scaling(benchmark::State& state, const std::string& family, double elapsed_seconds) {
+    static std::mutex mutex;
+    static std::map<std::string, double> baselines;
+
+    if (state.thread_index() != 0 || elapsed_seconds <= 0)
+        return;
+
+    double throughput = static_cast<double>(ops_per_thread) * state.threads() / elapsed_seconds;
+    state.counters["ops_per_sec"] = throughput;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (state.threads() == 1)
+        baselines[family] = throughput;
+
+    auto it = baselines.find(family);
+    if (it != baselines.end() && it->second > 0)
+        state.counters["efficiency"] = throughput / (it->second * state.threads());
+}
+
+// Shared state of one run, created by thread 0 while the others wait at
+// the start of the timed loop
+template<typename Adapter>
+struct Run {
+    using Clock = std::chrono::steady_clock;
+
+    std::unique_ptr<Adapter> allocator;
+    std::unique_ptr<SpscQueue<typename Adapter::Item>[]> queues;
+    std::atomic<int64_t> first_start{0};            // Clock ticks
+    std::atomic<int64_t> last_stop{0};
+    std::atomic<int> finished{0};
+    std::atomic<size_t> failures{0};
+    std::atomic<size_t> spilled{0};                 // CrossThread blocks freed locally
+
+    void setup(benchmark::State& state) {
+        allocator = std::make_unique<Adapter>(state.threads());
+        queues = std::make_unique<SpscQueue<typename Adapter::Item>[]>(static_cast<size_t>(state.threads()));
+        first_start.store(INT64_MAX, std::memory_order_relaxed);
+        last_stop.store(0, std::memory_order_relaxed);
+        finished.store(0, std::memory_order_relaxed);
+        failures.store(0, std::memory_order_relaxed);
+        spilled.store(0, std::memory_order_relaxed);
+    }
+
+    static int64_t now() noexcept {
+        return Clock::now().time_since_epoch().count();
+    }
+
+    // Called by each thread on its first iteration
+    void started(int64_t t) noexcept {
+        int64_t prev = first_start.load(std::memory_order_relaxed);
+        while (t < prev && !first_start.compare_exchange_weak(prev, t, std::memory_order_relaxed)) {}
+    }
+
+    // Called by each thread once its loop is done
+    void stopped() noexcept {
+        int64_t t = now();
+        int64_t prev = last_stop.load(std::memory_order_relaxed);
+        while (t > prev && !last_stop.compare_exchange_weak(prev, t, std::memory_order_relaxed)) {}
+        finished.fetch_add(1, std::memory_order_acq_rel);
+    }
+
+    // Wall time from the first thread starting to the last one stopping
+    double seconds() const noexcept {
+        Clock::duration elapsed(last_stop.load(std::memory_order_relaxed) - first_start.load(std::memory_order_relaxed));
+        return std::chrono::duration<double>(elapsed).count();
+    }
+};
+
+template<typename Adapter>
+Run<Adapter>& run_state() {
+    static Run<Adapter> run;
+    return run;
+}
+
+// Thread 0 reports for the whole run once every thread has stopped
+template<typename Adapter>
+void complete(benchmark::State& state, Run<Adapter>& run, const char* workload) {
+    if (state.thread_index() == 0) {
+        while (run.finished.load(std::memory_order_acquire) != state.threads())
+            std::this_thread::yield();
+
+        report_scaling(state, std::string(workload) + "/" + Adapter::name, run.seconds());
+        state.counters["failures"] = static_cast<double>(run.failures.load(std::memory_order_relaxed));
+        if (std::string_view(workload) == "CrossThread")
+            state.counters["spilled"] = static_cast<double>(run.spilled.load(std::memory_order_relaxed));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// WORKLOADS
+
+// Allocate a batch, free it, repeat
+template<typename Adapter>
+void BM_AllLocal(benchmark::State& state) {
+    Run<Adapter>& run = run_state<Adapter>();
+    if (state.thread_index() == 0)
+        run.setup(state);
+
+    std::vector<typename Adapter::Item> batch(local_batch);
+    size_t n = 0;
+    bool first = true;
+
+    for (auto _ : state) {
+        if (first) {
+            run.started(Run<Adapter>::now());
+            first = false;
+        }
+
+        batch[n] = run.allocator->allocate();
+        if (is_empty(batch[n]))
+            run.failures.fetch_add(1, std::memory_order_relaxed);
+
+        if (++n == local_batch) {
+            for (auto& item : batch)
+                run.allocator->deallocate(item);
+            n = 0;
+        }
+    }
+
+    for (size_t i = 0; i < n; ++i)
+        run.allocator->deallocate(batch[i]);
+    run.stopped();
+    complete(state, run, "AllLocal");
+}
+
+// Allocate, hand the block to the next thread, free what the previous one sent
+template<typename Adapter>
+void BM_CrossThread(benchmark::State& state) {
+    using Item = typename Adapter::Item;
+
+    Run<Adapter>& run = run_state<Adapter>();
+    if (state.thread_index() == 0)
+        run.setup(state);
+
+    const int threads = state.threads();
+    const int me = state.thread_index();
+    SpscQueue<Item>* inbox = nullptr;
+    SpscQueue<Item>* outbox = nullptr;
+    Item item{};
+    bool first = true;
+
+    for (auto _ : state) {
+        // Thread 0 may still be creating the queues until the loop starts
+        if (first) {
+            inbox = &run.queues[static_cast<size_t>(me)];
+            outbox = &run.queues[static_cast<size_t>((me + 1) % threads)];
+            run.started(Run<Adapter>::now());
+            first = false;
+        }
+
+        Item block = run.allocator->allocate();
+        if (is_empty(block)) {
+            run.failures.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            // A neighbour that has finished its iterations stops draining, so
+            // don't wait on a full queue: free the block here and count it
+            if (!outbox->push(block)) {
+                run.allocator->deallocate(block);
+                run.spilled.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        if (inbox->pop(item))
+            run.allocator->deallocate(item);
+    }
+
+    // The loop ends at a barrier, so every block sent to us is already queued
+    run.stopped();
+    while (inbox->pop(item))
+        run.allocator->deallocate(item);
+    complete(state, run, "CrossThread");
+}
+
+// Threads [0, n/2) allocate into a queue each, threads [n/2, n) free from
+// them. With an odd count the last thread does both on its own queue.
+template<typename Adapter>
+void BM_ProducerConsumer(benchmark::State& state) {
+    using Item = typename Adapter::Item;
+
+    Run<Adapter>& run = run_state<Adapter>();
+    if (state.thread_index() == 0)
+        run.setup(state);
+
+    const int pairs = state.threads() / 2;
+    const int me = state.thread_index();
+    const bool both = me == 2 * pairs;
+    const bool producer = both || me < pairs;
+    const bool consumer = both || me >= pairs;
+    SpscQueue<Item>* queue = nullptr;
+    Item item{};
+    bool first = true;
+
+    for (auto _ : state) {
+        // Thread 0 may still be creating the queues until the loop starts
+        if (first) {
+            queue = &run.queues[static_cast<size_t>(both ? me : me % pairs)];
+            run.started(Run<Adapter>::now());
+            first = false;
+        }
+
+        if (producer) {
+            Item block = run.allocator->allocate();
+            if (is_empty(block))
+                run.failures.fetch_add(1, std::memory_order_relaxed);
+            while (!queue->push(block))
+                std::this_thread::yield();
+        }
+
+        // Every producer iteration pushes exactly one item, failed or not,
+        // so each consumer iteration has exactly one to take
+        if (consumer) {
+            while (!queue->pop(item))
+                std::this_thread::yield();
+            if (!is_empty(item))
+                run.allocator->deallocate(item);
+        }
+    }
+
+    run.stopped();
+    complete(state, run, "ProducerConsumer");
+}
+
+} // namespace
+
+#define ARENAX_SCALING_BENCHMARKS(workload)                                                 \
+    BENCHMARK_TEMPLATE(workload, MallocAdapter)                                              \
+        ->ThreadRange(1, max_threads)->Iterations(ops_per_thread)->UseRealTime();          \
+    BENCHMARK_TEMPLATE(workload, SharedArenaAdapter)                                         \
+        ->ThreadRange(1, max_threads)->Iterations(ops_per_thread)->UseRealTime();          \
+    BENCHMARK_TEMPLATE(workload, SharedPoolAdapter)                                          \
+        ->ThreadRange(1, max_threads)->Iterations(ops_per_thread)->UseRealTime();          \
+    BENCHMARK_TEMPLATE(workload, ArenaPoolAdapter)                                           \
+        ->ThreadRange(1, max_threads)->Iterations(ops_per_thread)->UseRealTime()
+
+ARENAX_SCALING_BENCHMARKS(BM_AllLocal);
+ARENAX_SCALING_BENCHMARKS(BM_CrossThread);
+ARENAX_SCALING_BENCHMARKS(BM_ProducerConsumer);
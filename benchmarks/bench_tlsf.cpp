@@ -0,0 +1,98 @@
+#include <benchmark/benchmark.h>
+#include "quanta/TlsfAllocator.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using namespace quanta;
+
+// Random alloc/free traffic over a bounded live set, timing every operation
+// individually so the worst case is visible next to the average.
+
+namespace {
+
+constexpr size_t live_slots = 1024;
+constexpr size_t min_size = 16;
+constexpr size_t max_size = 4096;
+
+struct Op {
+    size_t slot;
+    size_t size;
+};
+
+std::vector<Op> make_ops(size_t count) {
+    std::mt19937 rng(1234);
+    std::uniform_int_distribution<size_t> slot(0, live_slots - 1);
+    std::uniform_int_distribution<size_t> size(min_size, max_size);
+
+    std::vector<Op> ops(count);
+    for (Op& op : ops)
+        op = {slot(rng), size(rng)};
+    return ops;
+}
+
+struct MallocAdapter {
+    void* allocate(size_t size) noexcept { return std::malloc(size); }
+    void deallocate(void* p) noexcept { std::free(p); }
+};
+
+struct TlsfAdapter {
+    Arena arena;
+    TlsfAllocator tlsf;
+
+    TlsfAdapter() : arena(64 << 20), tlsf(arena, 64 << 20) {}
+    void* allocate(size_t size) noexcept { return tlsf.allocate(size); }
+    void deallocate(void* p) noexcept { tlsf.deallocate(p); }
+};
+
+// Each op frees whatever lives in a slot and allocates a new block there
+template<typename Adapter>
+void run_latency(benchmark::State& state) {
+    using Clock = std::chrono::steady_clock;
+
+    Adapter allocator;
+    std::vector<void*> slots(live_slots, nullptr);
+    std::vector<Op> ops = make_ops(1 << 16);
+    std::vector<int64_t> latencies;
+    latencies.reserve(ops.size());
+
+    size_t next = 0;
+    for (auto _ : state) {
+        const Op& op = ops[next];
+        next = (next + 1) % ops.size();
+
+        auto start = Clock::now();
+        allocator.deallocate(slots[op.slot]);
+        slots[op.slot] = allocator.allocate(op.size);
+        auto stop = Clock::now();
+
+        benchmark::DoNotOptimize(slots[op.slot]);
+        if (latencies.size() < latencies.capacity())
+            latencies.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count());
+    }
+
+    for (void* p : slots)
+        allocator.deallocate(p);
+
+    if (!latencies.empty()) {
+        std::sort(latencies.begin(), latencies.end());
+        state.counters["p50_ns"] = static_cast<double>(latencies[latencies.size() / 2]);
+        state.counters["p99_ns"] = static_cast<double>(latencies[latencies.size() * 99 / 100]);
+        state.counters["max_ns"] = static_cast<double>(latencies.back());
+    }
+}
+
+} // namespace
+
+static void BM_Tlsf_FreeAllocPair(benchmark::State& state) {
+    run_latency<TlsfAdapter>(state);
+}
+BENCHMARK(BM_Tlsf_FreeAllocPair);
+
+static void BM_Malloc_FreeAllocPair(benchmark::State& state) {
+    run_latency<MallocAdapter>(state);
+}
+BENCHMARK(BM_Malloc_FreeAllocPair);
@@ -1,27 +1,75 @@
 #pragma once
 
 #include "Common.hpp"
+#include "Debug.hpp"
+#include "Platform.hpp"
+#include "Stats.hpp"
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <cstdio>
+#include <cstring>
 #include <utility>
 
 namespace quanta {
 
+/**
+ * @brief On-disk header written by Arena::save(), followed by the arena bytes
+ *
+ * The header is padded to a whole page so the bytes can be mapped directly.
+ */
+struct ArenaSnapshotHeader {
+    static constexpr char expected_magic[8] = {'Q', 'A', 'R', 'E', 'N', 'A', 'S', 'N'};
+    static constexpr uint32_t current_version = 1;
+
+    char magic[8];
+    uint32_t version;
+    uint32_t data_offset;   // start of the arena bytes in the file
+    uint64_t used;          // number of arena bytes stored
+    uint64_t capacity;      // capacity of the saved arena
+};
+
 /**
  * @brief Fast bump-pointer allocator (linear/region allocator)
  */
 class Arena {
+public:
+    /**
+     * @brief How file pages are mapped by map_file()
+     */
+    enum class FileMode {
+        ReadOnly,       // file pages fault on write; allocations start on the next page
+        CopyOnWrite,    // file pages are writable, changes stay private to the arena
+    };
+
 private:
+    enum class Backing : uint8_t {
+        Heap,           // operator new
+        Borrowed,       // slice of a parent arena
+        Mapped,         // pages mapped from the OS
+        Shared,         // shared mapping of an anonymous file, see map_forkable()
+    };
+
     char* buffer_;
     size_t capacity_;
     size_t pos_;
+    size_t base_pos_;   // where reset() rewinds to (end of mapped file contents)
+    Arena* parent_;     // non-null for sub-arenas borrowing their buffer
+    uint32_t generation_ = 0;           // bumped by every reset()
+    uint32_t parent_generation_ = 0;    // parent's generation when this sub-arena was carved
+    Backing backing_;
+    bool frozen_;       // immutable after freeze()
+    int fd_;            // backing file of a forkable arena, -1 otherwise
+    QUANTA_NO_UNIQUE_ADDRESS ArenaCounters stats_;     // empty unless QUANTA_ARENA_STATS
+    QUANTA_NO_UNIQUE_ADDRESS debug::RedzoneChain redzones_;    // empty unless checked in software
 
 public:
 
     /**
      * @brief Construct an empty arena
      */
-    Arena() noexcept : buffer_(nullptr), capacity_(0), pos_(0) {}
+    Arena() noexcept
+        : buffer_(nullptr), capacity_(0), pos_(0), base_pos_(0), parent_(nullptr), backing_(Backing::Heap), frozen_(false), fd_(-1) {}
 
     /**
      * @brief Construct an arena with the given capacity
@@ -30,21 +78,27 @@ public:
      */
     explicit Arena(size_t capacity)
         : capacity_(capacity),
-          pos_ (0)
+          pos_ (0),
+          base_pos_(0),
+          parent_(nullptr),
+          backing_(Backing::Heap),
+          frozen_(false),
+          fd_(-1)
     {
         buffer_ = reinterpret_cast<char*>( ::operator new(capacity) );
+        debug::poison_untouched(buffer_, capacity_);
+        stats_.on_block();
     }
 
     /**
      * @brief Destructor - frees the arena's memory
+     * 
+     * A sub-arena hands its slice back to the parent instead, provided the
+     * slice is still the parent's most recent allocation and the parent has
+     * not been reset since the slice was carved.
      */
     ~Arena() {
-        if (buffer_ != nullptr) {
-            ::operator delete(buffer_);
-            buffer_ = nullptr;
-            pos_ = 0;
-            capacity_ = 0;
-        }
+        release();
     }
 
     // Arenas should not be copied
@@ -56,22 +110,251 @@ public:
     Arena(Arena&& other) noexcept 
         : buffer_(std::exchange(other.buffer_, nullptr)),
           capacity_(std::exchange(other.capacity_, 0)),
-          pos_(std::exchange(other.pos_, 0))
+          pos_(std::exchange(other.pos_, 0)),
+          base_pos_(std::exchange(other.base_pos_, 0)),
+          parent_(std::exchange(other.parent_, nullptr)),
+          generation_(std::exchange(other.generation_, 0)),
+          parent_generation_(std::exchange(other.parent_generation_, 0)),
+          backing_(std::exchange(other.backing_, Backing::Heap)),
+          frozen_(std::exchange(other.frozen_, false)),
+          fd_(std::exchange(other.fd_, -1)),
+          stats_(std::move(other.stats_)),
+          redzones_(std::exchange(other.redzones_, {}))
     {    }
 
     Arena& operator=(Arena&& other) noexcept {
         if (this != &other) {
-            if (buffer_) {
-                ::operator delete(buffer_);
-            }
+            release();
             
             buffer_ = std::exchange(other.buffer_, nullptr);
             capacity_ = std::exchange(other.capacity_, 0);
             pos_ = std::exchange(other.pos_, 0);
+            base_pos_ = std::exchange(other.base_pos_, 0);
+            parent_ = std::exchange(other.parent_, nullptr);
+            generation_ = std::exchange(other.generation_, 0);
+            parent_generation_ = std::exchange(other.parent_generation_, 0);
+            backing_ = std::exchange(other.backing_, Backing::Heap);
+            frozen_ = std::exchange(other.frozen_, false);
+            fd_ = std::exchange(other.fd_, -1);
+            stats_ = std::move(other.stats_);
+            redzones_ = std::exchange(other.redzones_, {});
         }
         return *this;
     }
 
+    /**
+     * @brief Create an arena on pages mapped directly from the OS
+     * 
+     * The memory is page-aligned and zero-filled, and physical pages are
+     * only committed when first touched. Unlike heap arenas, a mapped arena
+     * can be write-protected with freeze().
+     * 
+     * @param capacity Size of the arena in bytes (rounded up to whole pages)
+     * @return The arena, or an empty arena if the pages cannot be mapped
+     */
+    static Arena map_anonymous(size_t capacity) noexcept {
+        size_t size = align_up(std::max(capacity, size_t{1}), platform::page_size());
+        void* base = platform::map_pages(size);
+        if (base == nullptr)
+            return Arena();
+
+        Arena arena;
+        arena.buffer_ = static_cast<char*>(base);
+        arena.capacity_ = size;
+        arena.backing_ = Backing::Mapped;
+        debug::poison_untouched(arena.buffer_, arena.capacity_);
+        arena.stats_.on_block();
+        return arena;
+    }
+
+    /**
+     * @brief Create a mapped arena that supports fork()
+     * 
+     * The memory is a shared mapping of an anonymous in-memory file
+     * (memfd_create on Linux), which fork() remaps copy-on-write.
+     * 
+     * @param capacity Size of the arena in bytes (rounded up to whole pages)
+     * @return The arena, or an empty arena on failure or when unsupported
+     */
+    static Arena map_forkable(size_t capacity) noexcept {
+        platform::SharedMapping mapping = platform::create_shared(nullptr, capacity);
+        if (mapping.base == nullptr)
+            return Arena();
+
+        Arena arena;
+        arena.buffer_ = static_cast<char*>(mapping.base);
+        arena.capacity_ = mapping.size;
+        arena.backing_ = Backing::Shared;
+        arena.fd_ = mapping.fd;
+        debug::poison_untouched(arena.buffer_, arena.capacity_);
+        arena.stats_.on_block();
+        return arena;
+    }
+
+    /**
+     * @brief Create a copy-on-write child of an arena from map_forkable()
+     * 
+     * The child maps the same pages privately, so forking costs one mmap
+     * whatever the arena size. Reads share physical memory with the parent;
+     * the first write to a page gives the child its own copy. The child
+     * starts at the parent's position, bumps independently, and its reset()
+     * rewinds to the fork point. Discard a speculative change by destroying
+     * the child; keep it by moving the child into the parent's place (the
+     * result is no longer forkable).
+     * 
+     * While a child is alive the parent must not modify bytes allocated
+     * before the fork: pages the child has not written yet would see the
+     * change. Appending to the parent is fine. freeze() the parent to have
+     * this enforced.
+     * 
+     * @return The child, or an empty arena if this arena is not forkable
+     */
+    Arena fork() const noexcept {
+        if (backing_ != Backing::Shared || buffer_ == nullptr)
+            return Arena();
+
+        void* base = platform::map_private(fd_, capacity_);
+        if (base == nullptr)
+            return Arena();
+
+        Arena child;
+        child.buffer_ = static_cast<char*>(base);
+        child.capacity_ = capacity_;
+        child.pos_ = pos_;
+        child.base_pos_ = pos_;
+        child.backing_ = Backing::Mapped;
+        debug::poison_untouched(child.buffer_ + child.pos_, child.capacity_ - child.pos_);
+        child.stats_.on_block();
+        return child;
+    }
+
+    /**
+     * @brief Check whether fork() can be used on this arena
+     */
+    bool is_forkable() const noexcept {
+        return backing_ == Backing::Shared;
+    }
+
+    /**
+     * @brief Create an arena whose initial contents are a memory-mapped file
+     * 
+     * The file is mapped privately at the start of the arena, so loading is
+     * lazy and clean pages are shared with other processes mapping the same
+     * file. Allocations are appended after the file contents and reset()
+     * rewinds to that point rather than to zero. Read the contents through
+     * data().
+     * 
+     * @param path File to map
+     * @param mode Whether file pages are read-only or private copy-on-write
+     * @param capacity Total arena size in bytes (at least the file size)
+     * @return The arena, or an empty arena if the file cannot be mapped
+     */
+    static Arena map_file(const char* path, FileMode mode = FileMode::ReadOnly, size_t capacity = 0) noexcept {
+        platform::FileMapping mapping = platform::map_file(path, capacity, mode == FileMode::CopyOnWrite);
+        if (mapping.base == nullptr)
+            return Arena();
+
+        // Read-only file pages cannot take allocations, so skip the partial last page
+        size_t start = mode == FileMode::ReadOnly
+                           ? align_up(mapping.file_size, platform::page_size())
+                           : mapping.file_size;
+
+        Arena arena;
+        arena.buffer_ = static_cast<char*>(mapping.base);
+        arena.capacity_ = mapping.size;
+        arena.pos_ = start;
+        arena.base_pos_ = start;
+        arena.backing_ = Backing::Mapped;
+        debug::poison_untouched(arena.buffer_ + start, arena.capacity_ - start);
+        arena.stats_.on_block();
+        return arena;
+    }
+
+    /**
+     * @brief Write the allocated bytes to a snapshot file
+     * 
+     * Only position-independent data survives a save/load round trip: link
+     * structures with offset_ptr (or plain offsets), not raw pointers.
+     * 
+     * @param path File to create or overwrite
+     * @return true if the whole snapshot was written
+     */
+    bool save(const char* path) const noexcept {
+        ArenaSnapshotHeader header{};
+        std::memcpy(header.magic, ArenaSnapshotHeader::expected_magic, sizeof(header.magic));
+        header.version = ArenaSnapshotHeader::current_version;
+        header.data_offset = static_cast<uint32_t>(platform::page_size());
+        header.used = pos_;
+        header.capacity = capacity_;
+
+        std::FILE* file = std::fopen(path, "wb");
+        if (file == nullptr)
+            return false;
+
+        // Redzones and padding are written too, so they cannot stay poisoned
+        debug::unpoison(buffer_, pos_);
+
+        bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1;
+
+        // Pad the header to a page so the bytes map at a page-aligned offset
+        for (size_t i = sizeof(header); ok && i < header.data_offset; ++i)
+            ok = std::fputc(0, file) != EOF;
+
+        if (ok && pos_ > 0)
+            ok = std::fwrite(buffer_, 1, pos_, file) == pos_;
+
+        return std::fclose(file) == 0 && ok;
+    }
+
+    /**
+     * @brief Restore a snapshot written by save() by mapping it copy-on-write
+     * 
+     * The bytes are mapped at whatever address the OS picks, so loading costs
+     * no copying; pages are read lazily on first access. The restored arena
+     * behaves like one from map_file() in CopyOnWrite mode: data() points at
+     * the saved bytes, allocation continues after them and reset() rewinds
+     * to their end.
+     * 
+     * @param path Snapshot file
+     * @param capacity Minimum capacity (the saved capacity is used if larger)
+     * @return The arena, or an empty arena if the file is missing or invalid
+     */
+    static Arena load(const char* path, size_t capacity = 0) noexcept {
+        ArenaSnapshotHeader header{};
+
+        std::FILE* file = std::fopen(path, "rb");
+        if (file == nullptr)
+            return Arena();
+        bool ok = std::fread(&header, sizeof(header), 1, file) == 1;
+        std::fclose(file);
+
+        if (!ok || std::memcmp(header.magic, ArenaSnapshotHeader::expected_magic, sizeof(header.magic)) != 0 ||
+            header.version != ArenaSnapshotHeader::current_version)
+            return Arena();
+
+        if (capacity < header.capacity)
+            capacity = static_cast<size_t>(header.capacity);
+
+        platform::FileMapping mapping = platform::map_file(path, capacity, true, header.data_offset);
+        if (mapping.base == nullptr)
+            return Arena();
+
+        if (mapping.file_size != header.used) {
+            platform::unmap_pages(mapping.base, mapping.size);
+            return Arena();
+        }
+
+        Arena arena;
+        arena.buffer_ = static_cast<char*>(mapping.base);
+        arena.capacity_ = mapping.size;
+        arena.pos_ = mapping.file_size;
+        arena.base_pos_ = mapping.file_size;
+        arena.backing_ = Backing::Mapped;
+        debug::poison_untouched(arena.buffer_ + arena.pos_, arena.capacity_ - arena.pos_);
+        arena.stats_.on_block();
+        return arena;
+    }
+
     /**
      * @brief Allocate memory with the given size and alignment
      * 
@@ -80,17 +363,32 @@ public:
      * @return Pointer to allocated memory or nullptr if out of memory
      */
     void* allocate(size_t size, size_t alignment) noexcept {
-        if (!is_power_of_2(alignment) || size == 0)
+        if (!is_power_of_2(alignment) || size == 0 || frozen_) {
+            stats_.on_failure();
             return nullptr;
+        }
 
-        // Align position
-        size_t aligned_pos = align_up(pos_, alignment);
+        // Align the address, not just the offset, so the buffer's own alignment does not matter
+        uintptr_t base = reinterpret_cast<uintptr_t>(buffer_);
+        size_t aligned_pos = align_up(base + pos_, alignment) - base;
 
-        // Check for overflow and out of memory
-        if (aligned_pos + size < aligned_pos || aligned_pos + size > capacity_) [[unlikely]]
+        // Check for overflow and out of memory (debug builds keep a redzone after each allocation)
+        if (aligned_pos < pos_ || aligned_pos > capacity_ || size > capacity_ - aligned_pos ||
+            debug::redzone > capacity_ - aligned_pos - size) [[unlikely]] {
+            stats_.on_failure();
             return nullptr;
+        }
 
-        pos_ = aligned_pos + size;
+        if constexpr (debug::enabled) {
+            debug::poison(buffer_ + pos_, aligned_pos - pos_);
+            debug::unpoison(buffer_ + aligned_pos, size);
+            debug::poison(buffer_ + aligned_pos + size, debug::redzone);
+            redzones_.push(buffer_, aligned_pos + size);
+        }
+
+        size_t old_pos = pos_;
+        pos_ = aligned_pos + size + debug::redzone;
+        stats_.on_allocate(size, pos_ - old_pos, pos_);
 
         return static_cast<void*>(buffer_ + aligned_pos);
     }
@@ -104,19 +402,144 @@ public:
      */
     template<typename T>
     T* allocate(size_t count = 1) noexcept {
-        if (count > SIZE_MAX / sizeof(T))
+        if (count > SIZE_MAX / sizeof(T)) {
+            stats_.on_failure();
             return nullptr;
+        }
         
         size_t total_size = sizeof(T) * count;
 
         return static_cast<T*>(allocate(total_size, alignof(T))); 
     }
 
+    /**
+     * @brief Carve a child arena out of this arena's free space
+     * 
+     * The child borrows a contiguous slice (no heap allocation) and bumps
+     * through it with its own position, so its capacity is a hard budget.
+     * When the child is destroyed the slice is returned to this arena if it
+     * is still the most recent allocation and this arena has not been reset
+     * since; after a reset the space may belong to newer allocations, so it
+     * is left alone. The child must not outlive (or see moved) this arena,
+     * and resetting this arena invalidates the child's memory (destroying
+     * the child afterwards is still safe).
+     * 
+     * @param capacity Size of the slice in bytes
+     * @param alignment Alignment of the slice start (must be power of 2)
+     * @return The sub-arena, or an empty arena if there is not enough room
+     */
+    Arena sub_arena(size_t capacity, size_t alignment = alignof(std::max_align_t)) noexcept {
+        void* slice = allocate(capacity, alignment);
+        if (slice == nullptr)
+            return Arena();
+
+        return Arena(static_cast<char*>(slice), capacity, this);
+    }
+
+    /**
+     * @brief Check whether this arena borrows its memory from a parent arena
+     */
+    bool is_sub_arena() const noexcept {
+        return backing_ == Backing::Borrowed;
+    }
+
+    /**
+     * @brief Grow or shrink the most recent allocation in place
+     * 
+     * Only the allocation at the top of the arena can be resized; anything
+     * else is left untouched.
+     * 
+     * @param ptr Pointer returned by the last allocation
+     * @param old_size Current size of that allocation in bytes
+     * @param new_size Requested size in bytes
+     * @return true if the allocation now spans new_size bytes
+     */
+    bool resize(void* ptr, size_t old_size, size_t new_size) noexcept {
+        char* p = static_cast<char*>(ptr);
+        if (p == nullptr || frozen_ || p < buffer_ || p + old_size + debug::redzone != buffer_ + pos_)
+            return false;
+
+        size_t offset = static_cast<size_t>(p - buffer_);
+        if (new_size > capacity_ - offset || debug::redzone > capacity_ - offset - new_size) [[unlikely]]
+            return false;
+
+        if constexpr (debug::enabled) {
+            redzones_.pop(buffer_);
+            if (new_size == 0) {
+                debug::poison(p, old_size + debug::redzone);
+            } else {
+                debug::unpoison(p, new_size);
+                if (new_size < old_size)
+                    debug::poison(p + new_size, old_size - new_size);
+                debug::poison(p + new_size, debug::redzone);
+                redzones_.push(buffer_, offset + new_size);
+            }
+        }
+
+        // A fully released allocation gives its redzone back too
+        pos_ = new_size == 0 ? offset : offset + new_size + debug::redzone;
+        if (new_size > old_size)
+            stats_.on_resize(new_size - old_size, new_size - old_size, pos_);
+        return true;
+    }
+
+    /**
+     * @brief Give an allocation back to the arena
+     * 
+     * Only the most recent allocation is actually reclaimed; anything else
+     * stays in use until reset().
+     * 
+     * @param ptr Pointer returned by allocate()
+     * @param size Size passed to allocate()
+     */
+    void deallocate(void* ptr, size_t size) noexcept {
+        resize(ptr, size, 0);
+    }
+
     /**
      * @brief Reset the arena, making all allocated memory available for reuse
+     * 
+     * Has no effect on a frozen arena.
      */
     void reset() noexcept {
-        pos_ = 0;
+        if (frozen_)
+            return;
+
+        redzones_.verify_all(buffer_);
+        redzones_.clear();
+        debug::poison(buffer_ + base_pos_, pos_ - base_pos_);
+        pos_ = base_pos_;
+        ++generation_;
+        stats_.on_reset();
+    }
+
+    /**
+     * @brief Make the arena immutable once it has been built
+     * 
+     * Afterwards allocate(), resize() and reset() fail or do nothing, so the
+     * contents can be read from any number of threads without locking. For
+     * mapped arenas (map_anonymous(), map_forkable(), map_file(), load(), fork()) the used pages are
+     * also made read-only, so a stray write faults instead of corrupting the
+     * data, and clean pages stay shareable with the parent after fork().
+     * Other arenas are only marked immutable. Freezing is permanent.
+     * 
+     * @return true if the used pages are now write-protected by the OS
+     */
+    bool freeze() noexcept {
+        frozen_ = true;
+        if ((backing_ != Backing::Mapped && backing_ != Backing::Shared) || buffer_ == nullptr || pos_ == 0)
+            return false;
+
+        // The partial last page is protected too: nothing can be allocated there any more
+        size_t size = std::min(align_up(pos_, platform::page_size()), capacity_);
+        return platform::protect_pages(buffer_, size, false);
+    }
+
+    /**
+     * @brief Check whether freeze() has been called
+     */
+    bool is_frozen() const noexcept {
+        return frozen_;
     }
 
     /**
@@ -140,6 +563,23 @@ public:
         return (capacity_ - pos_);
     }
 
+    /**
+     * @brief Get the allocation statistics (all zero unless built with QUANTA_ARENA_STATS)
+     * 
+     * May be called from any thread while the owning thread allocates; the
+     * counters are read individually, so a snapshot can be slightly torn.
+     */
+    ArenaStats stats() const noexcept {
+        return stats_.snapshot();
+    }
+
+    /**
+     * @brief Get the start of the arena's memory (the file contents for map_file())
+     */
+    char* data() const noexcept {
+        return buffer_;
+    }
+
     /**
      * @brief Check if ptr belongs to arena
      * 
@@ -148,6 +588,59 @@ public:
     bool owns(void* ptr) const noexcept {
         return ptr >= buffer_ && ptr < buffer_ + capacity_;
     }
+
+private:
+    // Sub-arena over a slice of the parent's buffer
+    Arena(char* buffer, size_t capacity, Arena* parent) noexcept
+        : buffer_(buffer), capacity_(capacity), pos_(0), base_pos_(0), parent_(parent),
+          parent_generation_(parent->generation_), backing_(Backing::Borrowed), frozen_(false), fd_(-1)
+    {
+        debug::poison_untouched(buffer_, capacity_);
+        stats_.on_block();
+    }
+
+    void release() noexcept {
+        if (buffer_ == nullptr)
+            return;
+
+        // A reset parent may have reused a sub-arena's slice, links included
+        if (backing_ != Backing::Borrowed || parent_->generation_ == parent_generation_)
+            redzones_.verify_all(buffer_);
+        redzones_.clear();
+
+        // Hand memory back unpoisoned; a sub-arena's slice is re-poisoned by its parent
+        if (backing_ != Backing::Borrowed)
+            debug::unpoison(buffer_, capacity_);
+
+        switch (backing_) {
+        case Backing::Heap:
+            ::operator delete(buffer_);
+            break;
+        case Backing::Borrowed:
+            // Not after a parent reset: a newer allocation may end where the slice did
+            if (parent_->generation_ == parent_generation_)
+                parent_->resize(buffer_, capacity_, 0);
+            break;
+        case Backing::Mapped:
+            platform::unmap_pages(buffer_, capacity_);
+            break;
+        case Backing::Shared: {
+            platform::SharedMapping mapping{buffer_, capacity_, fd_};
+            platform::close_shared(mapping);
+            break;
+        }
+        }
+
+        buffer_ = nullptr;
+        capacity_ = 0;
+        pos_ = 0;
+        base_pos_ = 0;
+        parent_ = nullptr;
+        parent_generation_ = 0;
+        backing_ = Backing::Heap;
+        frozen_ = false;
+        fd_ = -1;
+    }
 };
 
 } // namespace quanta
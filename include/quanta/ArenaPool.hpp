@@ -0,0 +1,347 @@
+#pragma once
+
+#include "Arena.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace quanta {
+
+/**
+ * @brief Recycles whole pre-warmed arenas across short-lived tasks
+ *
+ * Arenas are grouped into size buckets and created up front, with every page
+ * touched once so later requests do not pay for operator new or first-touch
+ * page faults. acquire() hands out a Lease that resets the arena and returns
+ * it on scope exit. Checkout and return go through a lock-free free list per
+ * bucket; trim() releases arenas that have been idle for too long, and they
+ * are recreated on demand.
+ *
+ * The pool must outlive every lease taken from it.
+ */
+class ArenaPool {
+public:
+    /**
+     * @brief Bucket configuration: count arenas of capacity bytes each
+     */
+    struct BucketConfig {
+        size_t capacity;
+        size_t count;
+    };
+
+    using Clock = std::chrono::steady_clock;
+
+private:
+    static constexpr uint32_t npos = UINT32_MAX;
+
+    // Slot states; only the thread that moves a slot out of idle may touch its arena
+    static constexpr uint32_t slot_idle = 0;        // in the free list (or about to be)
+    static constexpr uint32_t slot_leased = 1;
+    static constexpr uint32_t slot_trimming = 2;    // trim() is inspecting or releasing it
+
+    struct Slot {
+        Arena arena;
+        std::atomic<uint32_t> next{npos};
+        std::atomic<uint32_t> state{slot_idle};
+        std::atomic<int64_t> last_return{0};        // Clock ticks
+    };
+
+    struct Bucket {
+        size_t capacity = 0;
+        uint32_t count = 0;
+        std::unique_ptr<Slot[]> slots;
+        std::atomic<uint64_t> head{npos};           // (tag << 32) | slot index
+        std::atomic<bool> trimming{false};          // one trim() per bucket at a time
+    };
+
+    std::unique_ptr<Bucket[]> buckets_;
+    size_t bucket_count_;
+    std::atomic<size_t> resident_bytes_;
+
+public:
+
+    /**
+     * @brief RAII handle to an arena checked out of the pool
+     */
+    class Lease {
+    private:
+        ArenaPool* pool_;
+        Bucket* bucket_;
+        uint32_t slot_;
+
+        friend class ArenaPool;
+
+        Lease(ArenaPool* pool, Bucket* bucket, uint32_t slot) noexcept
+            : pool_(pool), bucket_(bucket), slot_(slot) {}
+
+    public:
+        Lease() noexcept : pool_(nullptr), bucket_(nullptr), slot_(npos) {}
+
+        ~Lease() {
+            release();
+        }
+
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+
+        Lease(Lease&& other) noexcept
+            : pool_(std::exchange(other.pool_, nullptr)),
+              bucket_(std::exchange(other.bucket_, nullptr)),
+              slot_(std::exchange(other.slot_, npos))
+        {    }
+
+        Lease& operator=(Lease&& other) noexcept {
+            if (this != &other) {
+                release();
+                pool_ = std::exchange(other.pool_, nullptr);
+                bucket_ = std::exchange(other.bucket_, nullptr);
+                slot_ = std::exchange(other.slot_, npos);
+            }
+            return *this;
+        }
+
+        /**
+         * @brief Reset the arena and return it to the pool early
+         */
+        void release() noexcept {
+            if (pool_ != nullptr) {
+                pool_->give_back(*bucket_, slot_);
+                pool_ = nullptr;
+                bucket_ = nullptr;
+                slot_ = npos;
+            }
+        }
+
+        explicit operator bool() const noexcept {
+            return pool_ != nullptr;
+        }
+
+        Arena& arena() const noexcept {
+            return bucket_->slots[slot_].arena;
+        }
+
+        Arena& operator*() const noexcept {
+            return arena();
+        }
+
+        Arena* operator->() const noexcept {
+            return &arena();
+        }
+    };
+
+    /**
+     * @brief Create and pre-warm every arena of every bucket
+     *
+     * @param buckets Bucket sizes and arena counts (order does not matter)
+     */
+    explicit ArenaPool(std::initializer_list<BucketConfig> buckets)
+        : buckets_(std::make_unique<Bucket[]>(buckets.size())),
+          bucket_count_(buckets.size()),
+          resident_bytes_(0)
+    {
+        std::vector<BucketConfig> sorted(buckets);
+        std::sort(sorted.begin(), sorted.end(),
+                  [](const BucketConfig& a, const BucketConfig& b) { return a.capacity < b.capacity; });
+
+        for (size_t i = 0; i < bucket_count_; ++i) {
+            Bucket& bucket = buckets_[i];
+            bucket.capacity = sorted[i].capacity;
+            bucket.count = static_cast<uint32_t>(std::min<size_t>(sorted[i].count, npos - 1));
+            bucket.slots = std::make_unique<Slot[]>(bucket.count);
+
+            for (uint32_t s = 0; s < bucket.count; ++s) {
+                warm(bucket, bucket.slots[s]);
+                push(bucket, s);
+            }
+        }
+    }
+
+    // Leases point back into the pool, so it stays in place
+    ArenaPool(const ArenaPool&) = delete;
+    ArenaPool& operator=(const ArenaPool&) = delete;
+
+    /**
+     * @brief Check out a reset arena with at least min_capacity bytes
+     *
+     * The smallest fitting bucket is tried first, then larger ones.
+     *
+     * @param min_capacity Required arena capacity in bytes
+     * @return Lease on the arena, empty if every fitting bucket is exhausted
+     */
+    Lease acquire(size_t min_capacity) noexcept {
+        for (size_t i = 0; i < bucket_count_; ++i) {
+            Bucket& bucket = buckets_[i];
+            if (bucket.capacity < min_capacity)
+                continue;
+
+            uint32_t slot;
+            if (!pop(bucket, slot))
+                continue;
+            claim(bucket.slots[slot]);
+
+            // Arenas released by trim() are recreated on checkout
+            if (bucket.slots[slot].arena.capacity() == 0 && !warm(bucket, bucket.slots[slot])) [[unlikely]] {
+                bucket.slots[slot].state.store(slot_idle, std::memory_order_release);
+                push(bucket, slot);
+                continue;
+            }
+
+            return Lease(this, &bucket, slot);
+        }
+        return Lease();
+    }
+
+    /**
+     * @brief Free the memory of arenas idle for longer than max_idle
+     *
+     * Trimmed arenas keep their slot and are recreated by the next acquire()
+     * that lands on them. Idle arenas stay in the free list while trim()
+     * looks at them one at a time, so checkouts never fail because of a
+     * trim; one that pops the very arena being inspected waits for that
+     * arena only. A bucket already being trimmed by another thread is
+     * skipped.
+     *
+     * @param max_idle Idle time after which an arena's memory is released
+     * @param keep_warm Number of arenas per bucket kept regardless of idle time
+     * @return Number of arenas released
+     */
+    size_t trim(Clock::duration max_idle, size_t keep_warm = 0) noexcept {
+        int64_t now = Clock::now().time_since_epoch().count();
+        size_t trimmed = 0;
+
+        for (size_t i = 0; i < bucket_count_; ++i) {
+            Bucket& bucket = buckets_[i];
+
+            bool expected = false;
+            if (!bucket.trimming.compare_exchange_strong(expected, true, std::memory_order_acquire))
+                continue;
+
+            size_t kept = 0;
+            for (uint32_t index = 0; index < bucket.count; ++index) {
+                Slot& s = bucket.slots[index];
+                uint32_t state = slot_idle;
+                if (!s.state.compare_exchange_strong(state, slot_trimming, std::memory_order_acquire))
+                    continue;
+
+                if (s.arena.capacity() > 0) {
+                    bool idle = now - s.last_return.load(std::memory_order_relaxed) > max_idle.count();
+                    if (idle && kept >= keep_warm) {
+                        s.arena = Arena();
+                        resident_bytes_.fetch_sub(bucket.capacity, std::memory_order_relaxed);
+                        ++trimmed;
+                    } else {
+                        ++kept;
+                    }
+                }
+                s.state.store(slot_idle, std::memory_order_release);
+            }
+            bucket.trimming.store(false, std::memory_order_release);
+        }
+        return trimmed;
+    }
+
+    /**
+     * @brief Get the number of size buckets
+     */
+    size_t bucket_count() const noexcept {
+        return bucket_count_;
+    }
+
+    /**
+     * @brief Get the arena capacity of a bucket (buckets are sorted ascending)
+     */
+    size_t bucket_capacity(size_t bucket) const noexcept {
+        return bucket < bucket_count_ ? buckets_[bucket].capacity : 0;
+    }
+
+    /**
+     * @brief Get the bytes currently held by live (untrimmed) arenas
+     */
+    size_t resident_bytes() const noexcept {
+        return resident_bytes_.load(std::memory_order_relaxed);
+    }
+
+private:
+    // Allocate the slot's arena and fault in every page
+    bool warm(Bucket& bucket, Slot& slot) noexcept {
+        try {
+            slot.arena = Arena(bucket.capacity);
+        } catch (const std::bad_alloc&) {
+            return false;
+        }
+
+        // Debug builds keep a redzone after every allocation, so leave room for it
+        size_t touch = bucket.capacity > debug::redzone ? bucket.capacity - debug::redzone : 0;
+        if (void* p = touch > 0 ? slot.arena.allocate(touch, 1) : nullptr) {
+            volatile char* bytes = static_cast<char*>(p);
+            size_t stride = platform::page_size();
+            for (size_t offset = 0; offset < touch; offset += stride)
+                bytes[offset] = 0;
+        }
+        slot.arena.reset();
+
+        // A freshly warmed arena counts as just returned, not idle since the epoch
+        slot.last_return.store(Clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+
+        resident_bytes_.fetch_add(bucket.capacity, std::memory_order_relaxed);
+        return true;
+    }
+
+    void give_back(Bucket& bucket, uint32_t slot) noexcept {
+        Slot& s = bucket.slots[slot];
+        s.arena.reset();
+        s.last_return.store(Clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+        s.state.store(slot_idle, std::memory_order_release);
+        push(bucket, slot);
+    }
+
+    // Take ownership of a popped slot, waiting out a trim() that is inspecting it
+    static void claim(Slot& slot) noexcept {
+        uint32_t state = slot_idle;
+        while (!slot.state.compare_exchange_strong(state, slot_leased, std::memory_order_acquire)) {
+            state = slot_idle;
+            std::this_thread::yield();
+        }
+    }
+
+    // Treiber stack over slot indices; the tag in the upper half defeats ABA
+
+    static bool pop(Bucket& bucket, uint32_t& slot) noexcept {
+        uint64_t head = bucket.head.load(std::memory_order_acquire);
+        for (;;) {
+            uint32_t index = static_cast<uint32_t>(head);
+            if (index == npos)
+                return false;
+
+            uint64_t next = bucket.slots[index].next.load(std::memory_order_relaxed);
+            uint64_t desired = (((head >> 32) + 1) << 32) | next;
+            if (bucket.head.compare_exchange_weak(head, desired,
+                                                  std::memory_order_acquire,
+                                                  std::memory_order_acquire)) {
+                slot = index;
+                return true;
+            }
+        }
+    }
+
+    static void push(Bucket& bucket, uint32_t slot) noexcept {
+        uint64_t head = bucket.head.load(std::memory_order_relaxed);
+        uint64_t desired;
+        do {
+            bucket.slots[slot].next.store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+            desired = (((head >> 32) + 1) << 32) | slot;
+        } while (!bucket.head.compare_exchange_weak(head, desired,
+                                                    std::memory_order_release,
+                                                    std::memory_order_relaxed));
+    }
+};
+
+} // namespace quanta
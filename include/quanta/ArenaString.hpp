@@ -0,0 +1,341 @@
+#pragma once
+
+#include "Arena.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <optional>
+#include <string_view>
+
+namespace quanta {
+
+/**
+ * @brief Immutable string stored inline when short, otherwise in an Arena
+ *
+ * Strings of up to inline_capacity bytes live inside the object itself and
+ * never touch the arena. Longer strings reference arena memory and stay valid
+ * until the arena is reset. The contents are not null-terminated.
+ */
+class ArenaString {
+public:
+    static constexpr size_t inline_capacity = 16;
+
+private:
+    size_t size_;
+    union {
+        const char* ptr_;
+        char inline_[inline_capacity];
+    };
+
+public:
+
+    /**
+     * @brief Construct an empty string
+     */
+    ArenaString() noexcept : size_(0), ptr_(nullptr) {}
+
+    /**
+     * @brief Copy a string, placing it in the arena only if it does not fit inline
+     *
+     * @param arena Arena receiving long strings
+     * @param str String to copy
+     * @return The new string or std::nullopt if the arena is out of memory
+     */
+    static std::optional<ArenaString> copy(Arena& arena, std::string_view str) noexcept {
+        if (str.size() <= inline_capacity)
+            return make_inline(str);
+
+        char* bytes = arena.allocate<char>(str.size());
+        if (bytes == nullptr) [[unlikely]]
+            return std::nullopt;
+
+        std::memcpy(bytes, str.data(), str.size());
+        return make_external(std::string_view(bytes, str.size()));
+    }
+
+    /**
+     * @brief Wrap bytes that already live in an arena without copying them
+     *
+     * Short strings are still copied inline so the result never depends on
+     * the arena for them.
+     *
+     * @param arena_bytes View into memory that outlives the returned string
+     */
+    static ArenaString adopt(std::string_view arena_bytes) noexcept {
+        if (arena_bytes.size() <= inline_capacity)
+            return make_inline(arena_bytes);
+        return make_external(arena_bytes);
+    }
+
+    const char* data() const noexcept {
+        return is_inline() ? inline_ : ptr_;
+    }
+
+    size_t size() const noexcept {
+        return size_;
+    }
+
+    bool empty() const noexcept {
+        return size_ == 0;
+    }
+
+    /**
+     * @brief Check whether the bytes are stored inside the object
+     */
+    bool is_inline() const noexcept {
+        return size_ <= inline_capacity;
+    }
+
+    std::string_view view() const noexcept {
+        return std::string_view(data(), size_);
+    }
+
+    operator std::string_view() const noexcept {
+        return view();
+    }
+
+    const char* begin() const noexcept {
+        return data();
+    }
+
+    const char* end() const noexcept {
+        return data() + size_;
+    }
+
+    friend bool operator==(const ArenaString& lhs, const ArenaString& rhs) noexcept {
+        return lhs.view() == rhs.view();
+    }
+
+    friend bool operator==(const ArenaString& lhs, std::string_view rhs) noexcept {
+        return lhs.view() == rhs;
+    }
+
+private:
+    static ArenaString make_inline(std::string_view str) noexcept {
+        ArenaString s;
+        s.size_ = str.size();
+        if (!str.empty())
+            std::memcpy(s.inline_, str.data(), str.size());
+        return s;
+    }
+
+    static ArenaString make_external(std::string_view str) noexcept {
+        ArenaString s;
+        s.size_ = str.size();
+        s.ptr_ = str.data();
+        return s;
+    }
+};
+
+/**
+ * @brief Incrementally builds a string at the tail of an Arena
+ *
+ * While the builder's buffer is the arena's most recent allocation it grows
+ * in place through Arena::resize(), so appends never copy. If something else
+ * was allocated in between, the buffer is relocated with geometric growth.
+ * When the arena runs out of memory the builder stops accepting input and
+ * failed() reports it; the bytes written so far are kept.
+ */
+class ArenaStringBuilder {
+private:
+    Arena* arena_;
+    char* data_;
+    size_t size_;
+    size_t capacity_;
+    bool failed_;
+
+    static constexpr size_t min_capacity = 32;
+
+public:
+
+    /**
+     * @brief Output iterator appending to the builder, usable with std::format_to
+     */
+    class iterator {
+    private:
+        ArenaStringBuilder* builder_;
+
+    public:
+        using iterator_category = std::output_iterator_tag;
+        using value_type = void;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = void;
+
+        iterator() noexcept : builder_(nullptr) {}
+        explicit iterator(ArenaStringBuilder& builder) noexcept : builder_(&builder) {}
+
+        iterator& operator=(char c) noexcept {
+            builder_->push_back(c);
+            return *this;
+        }
+
+        iterator& operator*() noexcept { return *this; }
+        iterator& operator++() noexcept { return *this; }
+        iterator operator++(int) noexcept { return *this; }
+    };
+
+    /**
+     * @brief Construct a builder appending into the given arena
+     *
+     * @param arena Arena receiving the string bytes
+     * @param reserve Initial capacity hint in bytes (0 defers allocation)
+     */
+    explicit ArenaStringBuilder(Arena& arena, size_t reserve = 0) noexcept
+        : arena_(&arena), data_(nullptr), size_(0), capacity_(0), failed_(false)
+    {
+        if (reserve > 0)
+            this->reserve(reserve);
+    }
+
+    // Builders own a live tail allocation, so they are neither copied nor moved
+    ArenaStringBuilder(const ArenaStringBuilder&) = delete;
+    ArenaStringBuilder& operator=(const ArenaStringBuilder&) = delete;
+
+    /**
+     * @brief Ensure room for at least capacity bytes
+     *
+     * @return false if the arena could not provide the space
+     */
+    bool reserve(size_t capacity) noexcept {
+        if (capacity <= capacity_)
+            return true;
+        return grow(capacity);
+    }
+
+    /**
+     * @brief Append a string
+     *
+     * @return false if the builder has failed (the input is dropped)
+     */
+    bool append(std::string_view str) noexcept {
+        if (failed_) [[unlikely]]
+            return false;
+
+        if (str.size() > capacity_ - size_) {
+            if (str.size() > SIZE_MAX - size_ || !grow(size_ + str.size())) [[unlikely]]
+                return false;
+        }
+
+        if (!str.empty())
+            std::memcpy(data_ + size_, str.data(), str.size());
+        size_ += str.size();
+        return true;
+    }
+
+    /**
+     * @brief Append a single character
+     */
+    bool push_back(char c) noexcept {
+        if (failed_) [[unlikely]]
+            return false;
+
+        if (size_ == capacity_ && !grow(size_ + 1)) [[unlikely]]
+            return false;
+
+        data_[size_++] = c;
+        return true;
+    }
+
+    ArenaStringBuilder& operator+=(std::string_view str) noexcept {
+        append(str);
+        return *this;
+    }
+
+    /**
+     * @brief Get an output iterator that appends to this builder
+     */
+    iterator out() noexcept {
+        return iterator(*this);
+    }
+
+    /**
+     * @brief View the bytes written so far (invalidated by further appends)
+     */
+    std::string_view view() const noexcept {
+        return std::string_view(data_, size_);
+    }
+
+    size_t size() const noexcept {
+        return size_;
+    }
+
+    size_t capacity() const noexcept {
+        return capacity_;
+    }
+
+    /**
+     * @brief Check whether an append was dropped for lack of memory
+     */
+    bool failed() const noexcept {
+        return failed_;
+    }
+
+    /**
+     * @brief Finish the current string and return a stable view of it
+     *
+     * Unused reserved bytes are handed back to the arena when the buffer is
+     * still at its tail. The builder is left empty and ready for a new string.
+     */
+    std::string_view freeze() noexcept {
+        std::string_view result(data_, size_);
+        if (data_ != nullptr)
+            arena_->resize(data_, capacity_, size_);
+        clear();
+        return result;
+    }
+
+    /**
+     * @brief Finish the current string as an ArenaString
+     *
+     * Results short enough to be stored inline give their arena bytes back
+     * when the buffer is still at the arena's tail.
+     */
+    ArenaString build() noexcept {
+        if (size_ > ArenaString::inline_capacity)
+            return ArenaString::adopt(freeze());
+
+        ArenaString result = ArenaString::adopt(view());
+        if (data_ != nullptr)
+            arena_->resize(data_, capacity_, 0);
+        clear();
+        return result;
+    }
+
+private:
+    void clear() noexcept {
+        data_ = nullptr;
+        size_ = 0;
+        capacity_ = 0;
+        failed_ = false;
+    }
+
+    bool grow(size_t needed) noexcept {
+        // Still at the arena tail: extend in place, nothing to copy
+        if (data_ != nullptr && arena_->resize(data_, capacity_, needed)) {
+            capacity_ = needed;
+            return true;
+        }
+
+        size_t new_capacity = std::max({needed, capacity_ * 2, min_capacity});
+        char* p = arena_->allocate<char>(new_capacity);
+        if (p == nullptr) {
+            new_capacity = needed;
+            p = arena_->allocate<char>(new_capacity);
+        }
+        if (p == nullptr) [[unlikely]] {
+            failed_ = true;
+            return false;
+        }
+
+        if (size_ > 0)
+            std::memcpy(p, data_, size_);
+        data_ = p;
+        capacity_ = new_capacity;
+        return true;
+    }
+};
+
+} // namespace quanta
@@ -0,0 +1,337 @@
+#pragma once
+
+#include "Arena.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+namespace quanta {
+
+/**
+ * @brief Binary buddy allocator over a power-of-two region taken from an Arena
+ *
+ * Requests are rounded up to a power-of-two block. Larger free blocks are
+ * split in halves down to that size and freed blocks are merged with their
+ * buddy whenever both halves are free, so fragmentation stays bounded.
+ * Allocation and deallocation are O(log n): the split/free state of every
+ * block lives in two bitmaps over the implicit block tree, and free blocks
+ * are kept on intrusive per-order lists for O(1) removal of a buddy.
+ *
+ * The region and bitmaps belong to the arena; resetting the arena
+ * invalidates the allocator.
+ */
+class BuddyAllocator {
+public:
+    static constexpr size_t max_orders = 48;
+
+private:
+    struct FreeNode {
+        FreeNode* prev;
+        FreeNode* next;
+    };
+
+    char* base_;
+    size_t region_size_;
+    size_t min_block_;
+    size_t max_alignment_;
+    unsigned depth_;                // depth of the leaves; the root is at depth 0
+    uint64_t* free_bits_;           // tree node is on a free list
+    uint64_t* split_bits_;          // tree node is split into two children
+    size_t free_bytes_;
+    std::array<FreeNode*, max_orders> free_lists_;     // indexed by depth
+
+public:
+
+    /**
+     * @brief Construct an empty allocator that cannot allocate
+     */
+    BuddyAllocator() noexcept
+        : base_(nullptr), region_size_(0), min_block_(0), max_alignment_(0),
+          depth_(0), free_bits_(nullptr), split_bits_(nullptr), free_bytes_(0),
+          free_lists_{} {}
+
+    /**
+     * @brief Take a region and its block-state bitmaps from an arena
+     *
+     * If the arena cannot provide them the allocator is left empty
+     * (capacity() == 0).
+     *
+     * @param arena Arena supplying the memory
+     * @param region_size Managed bytes, rounded down to a power of two
+     * @param min_block_size Smallest block handed out, rounded up to a power of two
+     */
+    BuddyAllocator(Arena& arena, size_t region_size, size_t min_block_size = 64) noexcept
+        : BuddyAllocator()
+    {
+        size_t min_block = std::bit_ceil(std::max(min_block_size, sizeof(FreeNode)));
+        if (region_size < min_block)
+            return;
+
+        size_t region = std::bit_floor(region_size);
+        unsigned depth = static_cast<unsigned>(std::countr_zero(region) - std::countr_zero(min_block));
+        if (depth >= max_orders)
+            return;
+
+        size_t words = bitmap_words(depth);
+        size_t alignment = std::min<size_t>(region, 4096);
+
+        char* base = static_cast<char*>(arena.allocate(region, alignment));
+        uint64_t* bits = base != nullptr ? arena.allocate<uint64_t>(2 * words) : nullptr;
+        if (bits == nullptr)
+            return;
+        std::memset(bits, 0, 2 * words * sizeof(uint64_t));
+
+        base_ = base;
+        region_size_ = region;
+        min_block_ = min_block;
+        max_alignment_ = alignment;
+        depth_ = depth;
+        free_bits_ = bits;
+        split_bits_ = bits + words;
+
+        push_free(0, 0);
+    }
+
+    // The allocator hands out pointers into its region, so it is not copied
+    BuddyAllocator(const BuddyAllocator&) = delete;
+    BuddyAllocator& operator=(const BuddyAllocator&) = delete;
+
+    BuddyAllocator(BuddyAllocator&& other) noexcept
+        : base_(std::exchange(other.base_, nullptr)),
+          region_size_(std::exchange(other.region_size_, 0)),
+          min_block_(std::exchange(other.min_block_, 0)),
+          max_alignment_(std::exchange(other.max_alignment_, 0)),
+          depth_(std::exchange(other.depth_, 0)),
+          free_bits_(std::exchange(other.free_bits_, nullptr)),
+          split_bits_(std::exchange(other.split_bits_, nullptr)),
+          free_bytes_(std::exchange(other.free_bytes_, 0)),
+          free_lists_(std::exchange(other.free_lists_, {}))
+    {    }
+
+    BuddyAllocator& operator=(BuddyAllocator&& other) noexcept {
+        if (this != &other) {
+            base_ = std::exchange(other.base_, nullptr);
+            region_size_ = std::exchange(other.region_size_, 0);
+            min_block_ = std::exchange(other.min_block_, 0);
+            max_alignment_ = std::exchange(other.max_alignment_, 0);
+            depth_ = std::exchange(other.depth_, 0);
+            free_bits_ = std::exchange(other.free_bits_, nullptr);
+            split_bits_ = std::exchange(other.split_bits_, nullptr);
+            free_bytes_ = std::exchange(other.free_bytes_, 0);
+            free_lists_ = std::exchange(other.free_lists_, {});
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Allocate a block of at least size bytes
+     *
+     * @param size Number of bytes to allocate
+     * @param alignment Alignment requirement (power of 2, at most max_alignment())
+     * @return Pointer to the block or nullptr if no block is large enough
+     */
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t)) noexcept {
+        if (!is_power_of_2(alignment) || size == 0 || alignment > max_alignment_)
+            return nullptr;
+
+        size_t needed = std::max({size, alignment, min_block_});
+        if (needed > region_size_) [[unlikely]]
+            return nullptr;
+
+        unsigned target = depth_for(std::bit_ceil(needed));
+
+        // Find the smallest free block that is large enough
+        unsigned depth = target;
+        while (free_lists_[depth] == nullptr) {
+            if (depth == 0)
+                return nullptr;
+            --depth;
+        }
+
+        size_t node = pop_free(depth);
+
+        // Split it down to the requested size, freeing the right halves
+        while (depth < target) {
+            set_bit(split_bits_, node);
+            node = 2 * node + 1;
+            ++depth;
+            push_free(node + 1, depth);
+        }
+
+        return block_address(node, depth);
+    }
+
+    /**
+     * @brief Type-safe allocation for objects of type T
+     */
+    template<typename T>
+    T* allocate(size_t count = 1) noexcept {
+        if (count > SIZE_MAX / sizeof(T))
+            return nullptr;
+
+        return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    /**
+     * @brief Free a block and merge it with its buddy as far as possible
+     *
+     * @param ptr Pointer returned by allocate() (nullptr is ignored)
+     */
+    void deallocate(void* ptr) noexcept {
+        if (ptr == nullptr || !owns(ptr))
+            return;
+
+        size_t offset = static_cast<size_t>(static_cast<char*>(ptr) - base_);
+
+        // Walk down the split nodes to the block that holds ptr
+        size_t node = 0;
+        unsigned depth = 0;
+        while (test_bit(split_bits_, node)) {
+            ++depth;
+            node = 2 * node + 1 + ((offset >> (log2_region() - depth)) & 1);
+        }
+
+        // Not the start of an allocated block (or freed twice)
+        if (test_bit(free_bits_, node) || offset != block_offset(node, depth)) [[unlikely]]
+            return;
+
+        // Coalesce with free buddies
+        while (depth > 0) {
+            size_t buddy = ((node - 1) ^ 1) + 1;
+            if (!test_bit(free_bits_, buddy))
+                break;
+
+            remove_free(buddy, depth);
+            node = (node - 1) / 2;
+            --depth;
+            clear_bit(split_bits_, node);
+        }
+
+        push_free(node, depth);
+    }
+
+    /**
+     * @brief Sized deallocation for composition; the size is not needed
+     */
+    void deallocate(void* ptr, size_t /*size*/) noexcept {
+        deallocate(ptr);
+    }
+
+    /**
+     * @brief Get the size of the block backing an allocation of size bytes
+     */
+    size_t block_size(size_t size) const noexcept {
+        return std::bit_ceil(std::max(size, min_block_));
+    }
+
+    /**
+     * @brief Get the total managed bytes
+     */
+    size_t capacity() const noexcept {
+        return region_size_;
+    }
+
+    /**
+     * @brief Get the number of bytes in free blocks
+     */
+    size_t available() const noexcept {
+        return free_bytes_;
+    }
+
+    /**
+     * @brief Get the number of bytes in allocated blocks
+     */
+    size_t used() const noexcept {
+        return region_size_ - free_bytes_;
+    }
+
+    /**
+     * @brief Get the largest alignment allocate() can honour
+     */
+    size_t max_alignment() const noexcept {
+        return max_alignment_;
+    }
+
+    /**
+     * @brief Check if ptr belongs to the managed region
+     *
+     * @param ptr Pointer to check
+     */
+    bool owns(void* ptr) const noexcept {
+        return ptr >= base_ && ptr < base_ + region_size_;
+    }
+
+private:
+    static size_t bitmap_words(unsigned depth) noexcept {
+        size_t nodes = (size_t{2} << depth) - 1;
+        return (nodes + 63) / 64;
+    }
+
+    unsigned log2_region() const noexcept {
+        return static_cast<unsigned>(std::countr_zero(region_size_));
+    }
+
+    unsigned depth_for(size_t block) const noexcept {
+        return log2_region() - static_cast<unsigned>(std::countr_zero(block));
+    }
+
+    // Node n at depth d covers [i * (region >> d), (i + 1) * (region >> d)) with i = n + 1 - 2^d
+    size_t block_offset(size_t node, unsigned depth) const noexcept {
+        return (node + 1 - (size_t{1} << depth)) << (log2_region() - depth);
+    }
+
+    char* block_address(size_t node, unsigned depth) const noexcept {
+        return base_ + block_offset(node, depth);
+    }
+
+    static bool test_bit(const uint64_t* bits, size_t i) noexcept {
+        return (bits[i / 64] >> (i % 64)) & 1;
+    }
+
+    static void set_bit(uint64_t* bits, size_t i) noexcept {
+        bits[i / 64] |= uint64_t{1} << (i % 64);
+    }
+
+    static void clear_bit(uint64_t* bits, size_t i) noexcept {
+        bits[i / 64] &= ~(uint64_t{1} << (i % 64));
+    }
+
+    void push_free(size_t node, unsigned depth) noexcept {
+        FreeNode* block = reinterpret_cast<FreeNode*>(block_address(node, depth));
+        block->prev = nullptr;
+        block->next = free_lists_[depth];
+        if (block->next != nullptr)
+            block->next->prev = block;
+        free_lists_[depth] = block;
+
+        set_bit(free_bits_, node);
+        free_bytes_ += region_size_ >> depth;
+    }
+
+    size_t pop_free(unsigned depth) noexcept {
+        FreeNode* block = free_lists_[depth];
+        size_t offset = static_cast<size_t>(reinterpret_cast<char*>(block) - base_);
+        size_t node = (size_t{1} << depth) - 1 + (offset >> (log2_region() - depth));
+        remove_free(node, depth);
+        return node;
+    }
+
+    void remove_free(size_t node, unsigned depth) noexcept {
+        FreeNode* block = reinterpret_cast<FreeNode*>(block_address(node, depth));
+        if (block->prev != nullptr)
+            block->prev->next = block->next;
+        else
+            free_lists_[depth] = block->next;
+        if (block->next != nullptr)
+            block->next->prev = block->prev;
+
+        clear_bit(free_bits_, node);
+        free_bytes_ -= region_size_ >> depth;
+    }
+};
+
+} // namespace quanta
@@ -0,0 +1,395 @@
+#pragma once
+
+#include "Common.hpp"
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace quanta {
+
+/**
+ * @brief Anything that hands out and takes back raw memory
+ *
+ * deallocate() receives the size originally requested, so composites can
+ * route a pointer back to the allocator that produced it without headers.
+ */
+template<typename A>
+concept Allocator = requires(A& a, void* ptr, size_t size, size_t alignment) {
+    { a.allocate(size, alignment) } -> std::same_as<void*>;
+    { a.deallocate(ptr, size) } -> std::same_as<void>;
+};
+
+/**
+ * @brief Allocator that can tell whether a pointer came from it (like Arena::owns)
+ */
+template<typename A>
+concept OwningAllocator = Allocator<A> && requires(const A& a, void* ptr) {
+    { a.owns(ptr) } -> std::same_as<bool>;
+};
+
+/**
+ * @brief Always fails; terminates a chain of fallbacks
+ */
+struct NullAllocator {
+    void* allocate(size_t, size_t) noexcept { return nullptr; }
+    void deallocate(void*, size_t) noexcept {}
+    bool owns(void* ptr) const noexcept { return ptr == nullptr; }
+};
+
+/**
+ * @brief std::malloc/std::free; cannot answer owns() so it only fits last in a chain
+ */
+struct Mallocator {
+    void* allocate(size_t size, size_t alignment) noexcept {
+        if (!is_power_of_2(alignment) || alignment > alignof(std::max_align_t) || size == 0)
+            return nullptr;
+        return std::malloc(size);
+    }
+
+    void deallocate(void* ptr, size_t) noexcept {
+        std::free(ptr);
+    }
+};
+
+/**
+ * @brief Non-owning handle so an existing allocator can be used as a building block
+ */
+template<Allocator A>
+class AllocatorRef {
+private:
+    A* allocator_;
+
+public:
+    explicit AllocatorRef(A& allocator) noexcept : allocator_(&allocator) {}
+
+    void* allocate(size_t size, size_t alignment) noexcept {
+        return allocator_->allocate(size, alignment);
+    }
+
+    void deallocate(void* ptr, size_t size) noexcept {
+        allocator_->deallocate(ptr, size);
+    }
+
+    bool owns(void* ptr) const noexcept requires OwningAllocator<A> {
+        return allocator_->owns(ptr);
+    }
+
+    A& get() const noexcept {
+        return *allocator_;
+    }
+};
+
+/**
+ * @brief Tries Primary first and falls back to Secondary when it fails
+ *
+ * Frees are routed with Primary::owns(), so Primary must be owning.
+ */
+template<OwningAllocator Primary, Allocator Secondary>
+class Fallback {
+private:
+    Primary primary_;
+    Secondary secondary_;
+
+public:
+    Fallback() = default;
+
+    Fallback(Primary primary, Secondary secondary) noexcept
+        : primary_(std::move(primary)), secondary_(std::move(secondary)) {}
+
+    void* allocate(size_t size, size_t alignment) noexcept {
+        if (void* p = primary_.allocate(size, alignment))
+            return p;
+        return secondary_.allocate(size, alignment);
+    }
+
+    void deallocate(void* ptr, size_t size) noexcept {
+        if (primary_.owns(ptr))
+            primary_.deallocate(ptr, size);
+        else
+            secondary_.deallocate(ptr, size);
+    }
+
+    bool owns(void* ptr) const noexcept requires OwningAllocator<Secondary> {
+        return primary_.owns(ptr) || secondary_.owns(ptr);
+    }
+
+    Primary& primary() noexcept { return primary_; }
+    Secondary& secondary() noexcept { return secondary_; }
+};
+
+/**
+ * @brief Sends requests of up to Threshold bytes to Small and the rest to Large
+ *
+ * Routing depends only on the size, so neither side needs owns().
+ */
+template<size_t Threshold, Allocator Small, Allocator Large>
+class Segregator {
+private:
+    Small small_;
+    Large large_;
+
+public:
+    Segregator() = default;
+
+    Segregator(Small small, Large large) noexcept
+        : small_(std::move(small)), large_(std::move(large)) {}
+
+    void* allocate(size_t size, size_t alignment) noexcept {
+        if (size <= Threshold)
+            return small_.allocate(size, alignment);
+        return large_.allocate(size, alignment);
+    }
+
+    void deallocate(void* ptr, size_t size) noexcept {
+        if (size <= Threshold)
+            small_.deallocate(ptr, size);
+        else
+            large_.deallocate(ptr, size);
+    }
+
+    bool owns(void* ptr) const noexcept requires OwningAllocator<Small> && OwningAllocator<Large> {
+        return small_.owns(ptr) || large_.owns(ptr);
+    }
+
+    Small& small() noexcept { return small_; }
+    Large& large() noexcept { return large_; }
+};
+
+/**
+ * @brief One allocator per size class: (Min, Min + Step], (Min + Step, Min + 2 * Step], ...
+ *
+ * Sizes outside (Min, Max] are rejected; combine with a Segregator to cover them.
+ */
+template<Allocator A, size_t Min, size_t Max, size_t Step>
+class Bucketizer {
+    static_assert(Step > 0 && Min < Max && (Max - Min) % Step == 0,
+                  "Bucketizer range must be a whole number of steps");
+
+public:
+    static constexpr size_t bucket_count = (Max - Min) / Step;
+
+private:
+    std::array<A, bucket_count> buckets_;
+
+public:
+    Bucketizer() = default;
+
+    /**
+     * @brief Construct every bucket from the same arguments, e.g. an Arena capacity
+     */
+    template<typename... Args>
+    explicit Bucketizer(const Args&... args) {
+        for (A& bucket : buckets_)
+            bucket = A(args...);
+    }
+
+    void* allocate(size_t size, size_t alignment) noexcept {
+        if (size <= Min || size > Max)
+            return nullptr;
+        return buckets_[index(size)].allocate(size, alignment);
+    }
+
+    void deallocate(void* ptr, size_t size) noexcept {
+        if (size <= Min || size > Max)
+            return;
+        buckets_[index(size)].deallocate(ptr, size);
+    }
+
+    bool owns(void* ptr) const noexcept requires OwningAllocator<A> {
+        for (const A& bucket : buckets_) {
+            if (bucket.owns(ptr))
+                return true;
+        }
+        return false;
+    }
+
+    A& bucket(size_t i) noexcept { return buckets_[i]; }
+
+private:
+    static size_t index(size_t size) noexcept {
+        return (size - Min - 1) / Step;
+    }
+};
+
+/**
+ * @brief Marker for an absent prefix or suffix in AffixAllocator
+ */
+struct NoAffix {};
+
+/**
+ * @brief Guard word for AffixAllocator, checked with intact() to catch overruns
+ */
+struct Canary {
+    static constexpr uint64_t pattern = 0xC0DEC0DEFEEDFACEull;
+    uint64_t value = pattern;
+
+    bool intact() const noexcept {
+        return value == pattern;
+    }
+};
+
+/**
+ * @brief Stores a Prefix object before and/or a Suffix object after each allocation
+ *
+ * Prefix and Suffix are default-constructed on allocate() and destroyed on
+ * deallocate(). The prefix sits at a fixed offset before the returned pointer,
+ * so alignments up to max_alignment are supported.
+ */
+template<Allocator A, typename Prefix, typename Suffix = NoAffix>
+class AffixAllocator {
+    static_assert(std::is_nothrow_default_constructible_v<Prefix> && std::is_nothrow_destructible_v<Prefix>);
+    static_assert(std::is_nothrow_default_constructible_v<Suffix> && std::is_nothrow_destructible_v<Suffix>);
+
+    static constexpr bool has_prefix = !std::is_same_v<Prefix, NoAffix>;
+    static constexpr bool has_suffix = !std::is_same_v<Suffix, NoAffix>;
+
+public:
+    static constexpr size_t max_alignment = std::max(alignof(Prefix), alignof(std::max_align_t));
+
+private:
+    static constexpr size_t prefix_offset =
+        has_prefix ? (sizeof(Prefix) + max_alignment - 1) / max_alignment * max_alignment : 0;
+
+    A parent_;
+
+public:
+    AffixAllocator() = default;
+
+    explicit AffixAllocator(A parent) noexcept : parent_(std::move(parent)) {}
+
+    void* allocate(size_t size, size_t alignment) noexcept {
+        if (!is_power_of_2(alignment) || alignment > max_alignment || size == 0)
+            return nullptr;
+
+        size_t total = suffix_offset(size);
+        if constexpr (has_suffix)
+            total += sizeof(Suffix);
+        if (total < size) [[unlikely]]
+            return nullptr;
+
+        char* raw = static_cast<char*>(parent_.allocate(total, max_alignment));
+        if (raw == nullptr)
+            return nullptr;
+
+        char* user = raw + prefix_offset;
+        if constexpr (has_prefix)
+            new (raw) Prefix();
+        if constexpr (has_suffix)
+            new (raw + suffix_offset(size)) Suffix();
+        return user;
+    }
+
+    void deallocate(void* ptr, size_t size) noexcept {
+        if (ptr == nullptr)
+            return;
+
+        char* raw = static_cast<char*>(ptr) - prefix_offset;
+        size_t total = suffix_offset(size);
+        if constexpr (has_prefix)
+            prefix(ptr).~Prefix();
+        if constexpr (has_suffix) {
+            suffix(ptr, size).~Suffix();
+            total += sizeof(Suffix);
+        }
+        parent_.deallocate(raw, total);
+    }
+
+    bool owns(void* ptr) const noexcept requires OwningAllocator<A> {
+        return parent_.owns(static_cast<char*>(ptr) - prefix_offset);
+    }
+
+    /**
+     * @brief Get the prefix object of an allocation
+     */
+    static Prefix& prefix(void* ptr) noexcept requires (has_prefix) {
+        return *std::launder(reinterpret_cast<Prefix*>(static_cast<char*>(ptr) - prefix_offset));
+    }
+
+    /**
+     * @brief Get the suffix object of an allocation of size bytes
+     */
+    static Suffix& suffix(void* ptr, size_t size) noexcept requires (has_suffix) {
+        char* raw = static_cast<char*>(ptr) - prefix_offset;
+        return *std::launder(reinterpret_cast<Suffix*>(raw + suffix_offset(size)));
+    }
+
+    A& parent() noexcept { return parent_; }
+
+private:
+    static size_t suffix_offset(size_t size) noexcept {
+        if constexpr (has_suffix)
+            return align_up(prefix_offset + size, alignof(Suffix));
+        else
+            return prefix_offset + size;
+    }
+};
+
+/**
+ * @brief Counts the traffic going through an allocator
+ *
+ * Counters are plain integers: wrap one StatsAllocator per thread or
+ * subsystem rather than sharing it.
+ */
+template<Allocator A>
+class StatsAllocator {
+public:
+    struct Stats {
+        size_t allocations = 0;
+        size_t deallocations = 0;
+        size_t failures = 0;
+        size_t bytes_allocated = 0;
+        size_t bytes_deallocated = 0;
+        size_t bytes_live = 0;
+        size_t peak_bytes_live = 0;
+    };
+
+private:
+    A parent_;
+    Stats stats_;
+
+public:
+    StatsAllocator() = default;
+
+    explicit StatsAllocator(A parent) noexcept : parent_(std::move(parent)) {}
+
+    void* allocate(size_t size, size_t alignment) noexcept {
+        void* p = parent_.allocate(size, alignment);
+        if (p == nullptr) {
+            ++stats_.failures;
+            return nullptr;
+        }
+
+        ++stats_.allocations;
+        stats_.bytes_allocated += size;
+        stats_.bytes_live += size;
+        stats_.peak_bytes_live = std::max(stats_.peak_bytes_live, stats_.bytes_live);
+        return p;
+    }
+
+    void deallocate(void* ptr, size_t size) noexcept {
+        if (ptr == nullptr)
+            return;
+
+        ++stats_.deallocations;
+        stats_.bytes_deallocated += size;
+        stats_.bytes_live -= std::min(size, stats_.bytes_live);
+        parent_.deallocate(ptr, size);
+    }
+
+    bool owns(void* ptr) const noexcept requires OwningAllocator<A> {
+        return parent_.owns(ptr);
+    }
+
+    const Stats& stats() const noexcept { return stats_; }
+    void reset_stats() noexcept { stats_ = Stats(); }
+
+    A& parent() noexcept { return parent_; }
+};
+
+} // namespace quanta
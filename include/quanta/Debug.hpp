@@ -0,0 +1,202 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <type_traits>
+
+/**
+ * Debug configuration, fixed at compile time. Define these before including
+ * any ArenaX header, and identically in every translation unit:
+ *
+ *  QUANTA_ARENA_DEBUG        1 enables redzones and poisoning (default 0)
+ *  QUANTA_ARENA_REDZONE      bytes left after every allocation in debug mode (default 16)
+ *  QUANTA_ARENA_GUARD_PAGES  1 also ends every GrowingArena block with an
+ *                            inaccessible page (default 0, needs QUANTA_ARENA_DEBUG)
+ *
+ * With the debug mode off every hook compiles to nothing.
+ *
+ * Under AddressSanitizer a write into a redzone is reported as it happens.
+ * Without it, redzones are filled with poison_byte and verified when the
+ * arena is reset, resized, deallocated from or destroyed; a damaged
+ * redzone prints the address and aborts. Software checking needs a
+ * redzone of at least 16 bytes (each one also stores a link to the
+ * previous one); with smaller redzones only ASan detects overruns.
+ */
+#ifndef QUANTA_ARENA_DEBUG
+    #define QUANTA_ARENA_DEBUG 0
+#endif
+
+#ifndef QUANTA_ARENA_REDZONE
+    #define QUANTA_ARENA_REDZONE 16
+#endif
+
+#ifndef QUANTA_ARENA_GUARD_PAGES
+    #define QUANTA_ARENA_GUARD_PAGES 0
+#endif
+
+#if defined(__SANITIZE_ADDRESS__)
+    #define QUANTA_HAS_ASAN 1
+#elif defined(__has_feature)
+    #if __has_feature(address_sanitizer)
+        #define QUANTA_HAS_ASAN 1
+    #endif
+#endif
+
+#ifndef QUANTA_HAS_ASAN
+    #define QUANTA_HAS_ASAN 0
+#endif
+
+#if QUANTA_HAS_ASAN
+    #include <sanitizer/asan_interface.h>
+#endif
+
+namespace quanta::debug {
+
+inline constexpr bool enabled = QUANTA_ARENA_DEBUG != 0;
+inline constexpr bool asan = QUANTA_HAS_ASAN != 0;
+inline constexpr size_t redzone = enabled ? QUANTA_ARENA_REDZONE : 0;
+inline constexpr bool guard_pages = enabled && QUANTA_ARENA_GUARD_PAGES != 0;
+
+// Fill for freed memory and redzones when AddressSanitizer is not available
+inline constexpr unsigned char poison_byte = 0xDD;
+
+// Whether redzones are verified in software (ASan checks them itself)
+inline constexpr bool check_redzones = enabled && !asan && redzone >= 2 * sizeof(size_t);
+
+/**
+ * @brief Mark memory as not allocated
+ *
+ * Under AddressSanitizer any access then reports an error. Without it the
+ * bytes are overwritten with poison_byte, so stale reads show up as
+ * garbage rather than as plausible old values.
+ */
+inline void poison(void* ptr, size_t size) noexcept {
+    if constexpr (enabled) {
+        if (size == 0)
+            return;
+#if QUANTA_HAS_ASAN
+        ASAN_POISON_MEMORY_REGION(ptr, size);
+#else
+        std::memset(ptr, poison_byte, size);
+#endif
+    }
+    (void)ptr; (void)size;
+}
+
+/**
+ * @brief Mark memory that has never been handed out as not allocated
+ *
+ * Only updates the AddressSanitizer shadow; never writes the memory, so
+ * large reservations are not committed.
+ */
+inline void poison_untouched(void* ptr, size_t size) noexcept {
+#if QUANTA_HAS_ASAN
+    if constexpr (enabled) {
+        if (size > 0)
+            ASAN_POISON_MEMORY_REGION(ptr, size);
+    }
+#endif
+    (void)ptr; (void)size;
+}
+
+/**
+ * @brief Mark memory as allocated again (required before returning it to the OS or heap)
+ */
+inline void unpoison(void* ptr, size_t size) noexcept {
+#if QUANTA_HAS_ASAN
+    if constexpr (enabled) {
+        if (size > 0)
+            ASAN_UNPOISON_MEMORY_REGION(ptr, size);
+    }
+#endif
+    (void)ptr; (void)size;
+}
+
+/**
+ * @brief Check whether AddressSanitizer considers a byte poisoned (always false without it)
+ */
+inline bool is_poisoned(const void* ptr) noexcept {
+#if QUANTA_HAS_ASAN
+    return __asan_address_is_poisoned(ptr) != 0;
+#else
+    (void)ptr;
+    return false;
+#endif
+}
+
+/**
+ * @brief Report a damaged redzone and abort
+ */
+[[noreturn]] inline void report_overrun(const void* redzone_start) noexcept {
+    std::fprintf(stderr, "quanta: write past the end of an arena allocation (redzone at %p overwritten)\n",
+                 redzone_start);
+    std::abort();
+}
+
+namespace detail {
+
+// Redzones of one bump region, newest first. The last bytes of each redzone
+// hold the offset where the previous one ends; the rest stays poison_byte.
+// An overrun reaches the poison bytes before the link, so a walk that
+// verifies them first never follows a damaged link.
+class RedzoneChain {
+private:
+    static constexpr size_t none = SIZE_MAX;
+    static constexpr size_t link_size = sizeof(size_t);
+
+    size_t top_ = none;     // end of the newest redzone
+
+    // Verify the redzone ending at end and return the previous one's end
+    static size_t verify(const char* data, size_t end) noexcept {
+        size_t start = end - redzone;
+        for (size_t i = start; i < end - link_size; ++i) {
+            if (static_cast<unsigned char>(data[i]) != poison_byte)
+                report_overrun(data + start);
+        }
+
+        size_t link;
+        std::memcpy(&link, data + end - link_size, link_size);
+        if (link != none && link >= start)
+            report_overrun(data + start);
+        return link;
+    }
+
+public:
+    // A redzone was just poisoned at [end, end + redzone)
+    void push(char* data, size_t end) noexcept {
+        std::memcpy(data + end + redzone - link_size, &top_, link_size);
+        top_ = end + redzone;
+    }
+
+    // Verify the newest redzone and drop it
+    void pop(const char* data) noexcept {
+        if (top_ != none)
+            top_ = verify(data, top_);
+    }
+
+    void verify_all(const char* data) const noexcept {
+        for (size_t end = top_; end != none;)
+            end = verify(data, end);
+    }
+
+    void clear() noexcept {
+        top_ = none;
+    }
+};
+
+// Stand-in when redzones are not checked in software
+struct NoRedzoneChain {
+    void push(char*, size_t) noexcept {}
+    void pop(const char*) noexcept {}
+    void verify_all(const char*) const noexcept {}
+    void clear() noexcept {}
+};
+
+} // namespace detail
+
+using RedzoneChain = std::conditional_t<check_redzones, detail::RedzoneChain, detail::NoRedzoneChain>;
+
+} // namespace quanta::debug
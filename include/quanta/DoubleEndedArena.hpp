@@ -0,0 +1,256 @@
+#pragma once
+
+#include "Common.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace quanta {
+
+/**
+ * @brief Bump allocator growing from both ends of a single buffer
+ *
+ * The bottom end grows upwards and the top end grows downwards; allocation
+ * fails once they would cross. Each end can be rewound to a marker on its own,
+ * giving two independent lifetimes (e.g. persistent level data at the bottom
+ * and per-frame scratch at the top) without fragmenting the buffer.
+ */
+class DoubleEndedArena {
+private:
+    char* buffer_;
+    size_t capacity_;
+    size_t bottom_;     // first free byte above the bottom stack
+    size_t top_;        // first used byte of the top stack
+
+public:
+    /**
+     * @brief Saved position of one end, see bottom_marker() and top_marker()
+     */
+    using Marker = size_t;
+
+    /**
+     * @brief Construct an empty arena
+     */
+    DoubleEndedArena() noexcept : buffer_(nullptr), capacity_(0), bottom_(0), top_(0) {}
+
+    /**
+     * @brief Construct an arena with the given capacity
+     *
+     * @param capacity Size of the arena in bytes, shared by both ends
+     */
+    explicit DoubleEndedArena(size_t capacity)
+        : capacity_(capacity),
+          bottom_(0),
+          top_(capacity)
+    {
+        buffer_ = reinterpret_cast<char*>( ::operator new(capacity) );
+    }
+
+    /**
+     * @brief Destructor - frees the arena's memory
+     */
+    ~DoubleEndedArena() {
+        if (buffer_ != nullptr)
+            ::operator delete(buffer_);
+    }
+
+    // Arenas should not be copied
+    DoubleEndedArena(const DoubleEndedArena&) = delete;
+    DoubleEndedArena& operator=(const DoubleEndedArena&) = delete;
+
+    // Arenas can be moved
+
+    DoubleEndedArena(DoubleEndedArena&& other) noexcept
+        : buffer_(std::exchange(other.buffer_, nullptr)),
+          capacity_(std::exchange(other.capacity_, 0)),
+          bottom_(std::exchange(other.bottom_, 0)),
+          top_(std::exchange(other.top_, 0))
+    {    }
+
+    DoubleEndedArena& operator=(DoubleEndedArena&& other) noexcept {
+        if (this != &other) {
+            if (buffer_) {
+                ::operator delete(buffer_);
+            }
+
+            buffer_ = std::exchange(other.buffer_, nullptr);
+            capacity_ = std::exchange(other.capacity_, 0);
+            bottom_ = std::exchange(other.bottom_, 0);
+            top_ = std::exchange(other.top_, 0);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Allocate memory from the bottom end
+     *
+     * @param size Number of bytes to allocate
+     * @param alignment Alignment requirement (must be power of 2)
+     * @return Pointer to allocated memory or nullptr if the ends would cross
+     */
+    void* allocate_bottom(size_t size, size_t alignment) noexcept {
+        if (!is_power_of_2(alignment) || size == 0)
+            return nullptr;
+
+        uintptr_t base = reinterpret_cast<uintptr_t>(buffer_);
+        size_t aligned_pos = align_up(base + bottom_, alignment) - base;
+
+        // Check for overflow and collision with the top end
+        if (aligned_pos < bottom_ || aligned_pos > top_ || size > top_ - aligned_pos) [[unlikely]]
+            return nullptr;
+
+        bottom_ = aligned_pos + size;
+
+        return static_cast<void*>(buffer_ + aligned_pos);
+    }
+
+    /**
+     * @brief Allocate memory from the top end
+     *
+     * @param size Number of bytes to allocate
+     * @param alignment Alignment requirement (must be power of 2)
+     * @return Pointer to allocated memory or nullptr if the ends would cross
+     */
+    void* allocate_top(size_t size, size_t alignment) noexcept {
+        if (!is_power_of_2(alignment) || size == 0)
+            return nullptr;
+
+        if (size > top_ - bottom_) [[unlikely]]
+            return nullptr;
+
+        // Align the new top downwards
+        uintptr_t base = reinterpret_cast<uintptr_t>(buffer_);
+        uintptr_t addr = (base + top_ - size) & ~(static_cast<uintptr_t>(alignment) - 1);
+
+        if (addr < base + bottom_) [[unlikely]]
+            return nullptr;
+
+        top_ = static_cast<size_t>(addr - base);
+
+        return static_cast<void*>(buffer_ + top_);
+    }
+
+    /**
+     * @brief Type-safe allocation from the bottom end
+     */
+    template<typename T>
+    T* allocate_bottom(size_t count = 1) noexcept {
+        if (count > SIZE_MAX / sizeof(T))
+            return nullptr;
+
+        return static_cast<T*>(allocate_bottom(sizeof(T) * count, alignof(T)));
+    }
+
+    /**
+     * @brief Type-safe allocation from the top end
+     */
+    template<typename T>
+    T* allocate_top(size_t count = 1) noexcept {
+        if (count > SIZE_MAX / sizeof(T))
+            return nullptr;
+
+        return static_cast<T*>(allocate_top(sizeof(T) * count, alignof(T)));
+    }
+
+    /**
+     * @brief Get a marker for the current bottom position
+     */
+    Marker bottom_marker() const noexcept {
+        return bottom_;
+    }
+
+    /**
+     * @brief Get a marker for the current top position
+     */
+    Marker top_marker() const noexcept {
+        return top_;
+    }
+
+    /**
+     * @brief Free every bottom allocation made after the marker was taken
+     *
+     * @param marker Value previously returned by bottom_marker()
+     */
+    void rewind_bottom(Marker marker) noexcept {
+        if (marker <= bottom_)
+            bottom_ = marker;
+    }
+
+    /**
+     * @brief Free every top allocation made after the marker was taken
+     *
+     * @param marker Value previously returned by top_marker()
+     */
+    void rewind_top(Marker marker) noexcept {
+        if (marker >= top_ && marker <= capacity_)
+            top_ = marker;
+    }
+
+    /**
+     * @brief Free all bottom allocations
+     */
+    void reset_bottom() noexcept {
+        bottom_ = 0;
+    }
+
+    /**
+     * @brief Free all top allocations
+     */
+    void reset_top() noexcept {
+        top_ = capacity_;
+    }
+
+    /**
+     * @brief Free both ends
+     */
+    void reset() noexcept {
+        reset_bottom();
+        reset_top();
+    }
+
+    /**
+     * @brief Get the number of bytes used by the bottom end
+     */
+    size_t used_bottom() const noexcept {
+        return bottom_;
+    }
+
+    /**
+     * @brief Get the number of bytes used by the top end
+     */
+    size_t used_top() const noexcept {
+        return capacity_ - top_;
+    }
+
+    /**
+     * @brief Get the number of bytes used by both ends
+     */
+    size_t used() const noexcept {
+        return used_bottom() + used_top();
+    }
+
+    /**
+     * @brief Get the total capacity of the arena
+     */
+    size_t capacity() const noexcept {
+        return capacity_;
+    }
+
+    /**
+     * @brief Get the number of bytes left between the two ends
+     */
+    size_t available() const noexcept {
+        return top_ - bottom_;
+    }
+
+    /**
+     * @brief Check if ptr belongs to arena
+     *
+     * @param ptr Pointer to check
+     */
+    bool owns(void* ptr) const noexcept {
+        return ptr >= buffer_ && ptr < buffer_ + capacity_;
+    }
+};
+
+} // namespace quanta
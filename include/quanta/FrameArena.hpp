@@ -0,0 +1,156 @@
+#pragma once
+
+#include "Arena.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace quanta {
+
+/**
+ * @brief Rotates between N arenas, one per frame in flight
+ *
+ * begin_frame() advances to the next arena and resets it, so memory handed
+ * out during frame k stays valid until frame k + N - 1 and is reclaimed when
+ * frame k + N begins. Use N = 2 for double buffering, N = 3 for triple.
+ *
+ * @tparam N Number of frames whose allocations are kept alive
+ */
+template<size_t N>
+class FrameArena {
+    static_assert(N >= 1, "FrameArena needs at least one arena");
+
+private:
+    std::array<Arena, N> arenas_;
+    size_t current_;
+    uint64_t frame_;
+
+public:
+
+    /**
+     * @brief Construct N arenas of the given capacity
+     *
+     * @param capacity_per_frame Size of each frame's arena in bytes
+     */
+    explicit FrameArena(size_t capacity_per_frame)
+        : current_(0),
+          frame_(0)
+    {
+        for (Arena& arena : arenas_)
+            arena = Arena(capacity_per_frame);
+    }
+
+    // Frame arenas can be moved but not copied, like Arena
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+    FrameArena(FrameArena&&) noexcept = default;
+    FrameArena& operator=(FrameArena&&) noexcept = default;
+
+    /**
+     * @brief Start a new frame, recycling the arena of frame (current - N + 1)
+     *
+     * @return Arena serving the new frame
+     */
+    Arena& begin_frame() noexcept {
+        current_ = (current_ + 1) % N;
+        ++frame_;
+        arenas_[current_].reset();
+        return arenas_[current_];
+    }
+
+    /**
+     * @brief Allocate memory in the current frame
+     *
+     * @param size Number of bytes to allocate
+     * @param alignment Alignment requirement (must be power of 2)
+     * @return Pointer to allocated memory or nullptr if out of memory
+     */
+    void* allocate(size_t size, size_t alignment) noexcept {
+        return arenas_[current_].allocate(size, alignment);
+    }
+
+    /**
+     * @brief Type-safe allocation in the current frame
+     */
+    template<typename T>
+    T* allocate(size_t count = 1) noexcept {
+        return arenas_[current_].template allocate<T>(count);
+    }
+
+    /**
+     * @brief Get the arena of the current frame
+     */
+    Arena& current() noexcept {
+        return arenas_[current_];
+    }
+
+    /**
+     * @brief Get the arena of an earlier frame that is still alive
+     *
+     * @param age 0 for the current frame, up to N - 1 for the oldest live one
+     */
+    Arena& previous(size_t age) noexcept {
+        return arenas_[(current_ + N - (age % N)) % N];
+    }
+
+    /**
+     * @brief Get the number of begin_frame() calls so far
+     */
+    uint64_t frame_index() const noexcept {
+        return frame_;
+    }
+
+    /**
+     * @brief Get the number of frames whose allocations are kept alive
+     */
+    static constexpr size_t frames_in_flight() noexcept {
+        return N;
+    }
+
+    /**
+     * @brief Get the bytes allocated in the current frame
+     */
+    size_t used() const noexcept {
+        return arenas_[current_].used();
+    }
+
+    /**
+     * @brief Get the bytes allocated across all live frames
+     */
+    size_t total_used() const noexcept {
+        size_t total = 0;
+        for (const Arena& arena : arenas_)
+            total += arena.used();
+        return total;
+    }
+
+    /**
+     * @brief Get the capacity of each frame's arena
+     */
+    size_t capacity() const noexcept {
+        return arenas_[current_].capacity();
+    }
+
+    /**
+     * @brief Check if ptr belongs to any live frame
+     *
+     * @param ptr Pointer to check
+     */
+    bool owns(void* ptr) const noexcept {
+        for (const Arena& arena : arenas_) {
+            if (arena.owns(ptr))
+                return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Reset every frame's arena
+     */
+    void reset() noexcept {
+        for (Arena& arena : arenas_)
+            arena.reset();
+    }
+};
+
+} // namespace quanta
@@ -0,0 +1,565 @@
+#pragma once
+
+#include "Common.hpp"
+#include "Debug.hpp"
+#include "Platform.hpp"
+#include "Stats.hpp"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+
+namespace quanta {
+
+/**
+ * @brief Learns a capacity from the peak usage of previous reset cycles
+ *
+ * Keeps the most recent peaks and weighs each by decay^age, so the estimate
+ * follows traffic changes instead of being pinned by an old spike. The
+ * estimate is the weighted percentile of the recorded peaks.
+ */
+class CapacityEstimator {
+public:
+    static constexpr size_t history = 32;
+
+private:
+    std::array<size_t, history> peaks_;
+    size_t count_;
+    size_t next_;
+    double percentile_;
+    double decay_;
+
+public:
+
+    /**
+     * @brief Construct an estimator
+     *
+     * @param percentile Fraction of cycles the estimate should cover, in (0, 1]
+     * @param decay Weight multiplier applied per cycle of age, in (0, 1]
+     */
+    explicit CapacityEstimator(double percentile = 0.9, double decay = 0.9) noexcept
+        : peaks_{}, count_(0), next_(0),
+          percentile_(std::clamp(percentile, 0.01, 1.0)),
+          decay_(std::clamp(decay, 0.01, 1.0)) {}
+
+    /**
+     * @brief Record the peak usage of a finished cycle
+     */
+    void record(size_t peak) noexcept {
+        peaks_[next_] = peak;
+        next_ = (next_ + 1) % history;
+        count_ = std::min(count_ + 1, history);
+    }
+
+    /**
+     * @brief Get the decayed percentile of the recorded peaks (0 if none)
+     */
+    size_t estimate() const noexcept {
+        struct Sample {
+            size_t peak;
+            double weight;
+        };
+
+        std::array<Sample, history> samples;
+        double weight = 1.0;
+        double total = 0.0;
+        for (size_t age = 0; age < count_; ++age) {
+            samples[age] = {peaks_[(next_ + history - 1 - age) % history], weight};
+            total += weight;
+            weight *= decay_;
+        }
+
+        std::sort(samples.begin(), samples.begin() + count_,
+                  [](const Sample& a, const Sample& b) { return a.peak < b.peak; });
+
+        double target = total * percentile_;
+        double cumulative = 0.0;
+        for (size_t i = 0; i < count_; ++i) {
+            cumulative += samples[i].weight;
+            if (cumulative >= target)
+                return samples[i].peak;
+        }
+        return count_ > 0 ? samples[count_ - 1].peak : 0;
+    }
+
+    /**
+     * @brief Get the number of cycles currently remembered
+     */
+    size_t samples() const noexcept {
+        return count_;
+    }
+};
+
+/**
+ * @brief Bump allocator that chains new blocks instead of failing
+ *
+ * When the current block is exhausted a new one is allocated and linked in;
+ * reset() keeps one block and frees the rest. With Sizing::Adaptive the arena
+ * records its peak usage at every reset() and sizes the next block from a
+ * CapacityEstimator, so a steady workload converges on a single block that
+ * fits it instead of chaining or over-reserving.
+ *
+ * Requests larger than large_threshold() (a quarter of the block size by
+ * default, and never less than min_large_size) bypass the blocks and get dedicated pages from the OS, so an
+ * occasional big payload neither abandons the tail of the current block nor
+ * forces a new block. Those mappings are returned on reset().
+ *
+ * In debug builds (see Debug.hpp) allocations are followed by poisoned
+ * redzones, and with QUANTA_ARENA_GUARD_PAGES every block ends in a guard
+ * page so running off the end of a block faults immediately.
+ */
+class GrowingArena {
+public:
+    enum class Sizing {
+        Fixed,      // every block has the configured size
+        Adaptive,   // block size follows the peaks of recent cycles
+    };
+
+    static constexpr size_t min_block_size = 256;
+    static constexpr size_t block_granularity = 4096;
+    static constexpr size_t min_large_size = 64 << 10;     // floor of the default large threshold
+
+private:
+    struct alignas(std::max_align_t) Block {
+        Block* next;        // older block
+        size_t capacity;
+        QUANTA_NO_UNIQUE_ADDRESS debug::RedzoneChain redzones;
+
+        char* data() noexcept {
+            return reinterpret_cast<char*>(this + 1);
+        }
+    };
+
+    // Header at the start of a dedicated mapping for one large allocation
+    struct LargeBlock {
+        LargeBlock* next;
+        size_t mapped_size;
+    };
+
+    Block* head_;           // current block, newest first
+    size_t pos_;            // position in the current block
+    size_t retired_used_;   // bytes used in the blocks behind head_
+    size_t block_size_;     // capacity of the next block to be allocated
+    size_t block_count_;
+    size_t reserved_;       // sum of block capacities
+    Sizing sizing_;
+    CapacityEstimator estimator_;
+    LargeBlock* large_;     // dedicated mappings, newest first
+    size_t large_used_;     // bytes requested through large_
+    size_t large_count_;
+    size_t large_threshold_;    // 0 means max(block_size_ / 4, min_large_size)
+    QUANTA_NO_UNIQUE_ADDRESS ArenaCounters stats_;     // empty unless QUANTA_ARENA_STATS
+
+public:
+
+    /**
+     * @brief Construct an arena; the first block is allocated on first use
+     *
+     * @param block_size Size of each block in bytes (initial size when adaptive)
+     * @param sizing Whether the block size is fixed or learnt from resets
+     * @param estimator Estimator used in adaptive mode
+     */
+    explicit GrowingArena(size_t block_size, Sizing sizing = Sizing::Fixed,
+                          CapacityEstimator estimator = CapacityEstimator()) noexcept
+        : head_(nullptr), pos_(0), retired_used_(0),
+          block_size_(std::max(block_size, min_block_size)),
+          block_count_(0), reserved_(0),
+          sizing_(sizing), estimator_(estimator),
+          large_(nullptr), large_used_(0), large_count_(0), large_threshold_(0), stats_() {}
+
+    /**
+     * @brief Destructor - frees every block
+     */
+    ~GrowingArena() {
+        check_redzones();
+        free_blocks(nullptr);
+        free_large();
+    }
+
+    // Arenas should not be copied
+    GrowingArena(const GrowingArena&) = delete;
+    GrowingArena& operator=(const GrowingArena&) = delete;
+
+    // Arenas can be moved
+
+    GrowingArena(GrowingArena&& other) noexcept
+        : head_(std::exchange(other.head_, nullptr)),
+          pos_(std::exchange(other.pos_, 0)),
+          retired_used_(std::exchange(other.retired_used_, 0)),
+          block_size_(other.block_size_),
+          block_count_(std::exchange(other.block_count_, 0)),
+          reserved_(std::exchange(other.reserved_, 0)),
+          sizing_(other.sizing_),
+          estimator_(other.estimator_),
+          large_(std::exchange(other.large_, nullptr)),
+          large_used_(std::exchange(other.large_used_, 0)),
+          large_count_(std::exchange(other.large_count_, 0)),
+          large_threshold_(other.large_threshold_),
+          stats_(std::move(other.stats_))
+    {    }
+
+    GrowingArena& operator=(GrowingArena&& other) noexcept {
+        if (this != &other) {
+            free_blocks(nullptr);
+            free_large();
+
+            head_ = std::exchange(other.head_, nullptr);
+            pos_ = std::exchange(other.pos_, 0);
+            retired_used_ = std::exchange(other.retired_used_, 0);
+            block_size_ = other.block_size_;
+            block_count_ = std::exchange(other.block_count_, 0);
+            reserved_ = std::exchange(other.reserved_, 0);
+            sizing_ = other.sizing_;
+            estimator_ = other.estimator_;
+            large_ = std::exchange(other.large_, nullptr);
+            large_used_ = std::exchange(other.large_used_, 0);
+            large_count_ = std::exchange(other.large_count_, 0);
+            large_threshold_ = other.large_threshold_;
+            stats_ = std::move(other.stats_);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Allocate memory with the given size and alignment
+     *
+     * @param size Number of bytes to allocate
+     * @param alignment Alignment requirement (must be power of 2)
+     * @return Pointer to allocated memory or nullptr if the system is out of memory
+     */
+    void* allocate(size_t size, size_t alignment) noexcept {
+        if (!is_power_of_2(alignment) || size == 0) {
+            stats_.on_failure();
+            return nullptr;
+        }
+
+        if (size > large_threshold())
+            return allocate_large(size, alignment);
+
+        if (head_ != nullptr) {
+            if (void* p = bump(size, alignment))
+                return p;
+        }
+
+        // Current block exhausted: chain a new one big enough for this request
+        if (size > SIZE_MAX - alignment - sizeof(Block) - debug::redzone) [[unlikely]] {
+            stats_.on_failure();
+            return nullptr;
+        }
+
+        if (!add_block(std::max(block_size_, size + alignment + debug::redzone))) {
+            stats_.on_failure();
+            return nullptr;
+        }
+
+        return bump(size, alignment);
+    }
+
+    /**
+     * @brief Type-safe allocation for objects of type T
+     *
+     * @tparam T Type to allocate
+     * @param count Number of objects to allocate (default 1)
+     * @return Pointer to allocated objects or nullptr if out of memory
+     */
+    template<typename T>
+    T* allocate(size_t count = 1) noexcept {
+        if (count > SIZE_MAX / sizeof(T)) {
+            stats_.on_failure();
+            return nullptr;
+        }
+
+        return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    /**
+     * @brief Reset the arena, keeping at most one block for the next cycle
+     *
+     * In adaptive mode the cycle's peak usage is recorded first and the block
+     * size re-estimated; the kept block is dropped too if it no longer fits
+     * the estimate. Large allocations are unmapped and do not count towards
+     * the estimate, since they never land in a block.
+     */
+    void reset() noexcept {
+        check_redzones();
+        free_large();
+
+        if (sizing_ == Sizing::Adaptive) {
+            estimator_.record(retired_used_ + pos_);
+            size_t target = align_up(std::max(estimator_.estimate(), min_block_size), block_granularity);
+            block_size_ = target;
+        }
+
+        // Keep the oldest block: it is the one sized for the start of a cycle
+        Block* keep = head_;
+        while (keep != nullptr && keep->next != nullptr)
+            keep = keep->next;
+
+        if (keep != nullptr && sizing_ == Sizing::Adaptive &&
+            (keep->capacity < block_size_ || keep->capacity > 2 * block_size_))
+            keep = nullptr;
+
+        if (keep != nullptr) {
+            keep->redzones.clear();
+            debug::poison(keep->data(), keep->capacity);
+        }
+
+        free_blocks(keep);
+        pos_ = 0;
+        retired_used_ = 0;
+        stats_.on_reset();
+    }
+
+    /**
+     * @brief Free every block, including the one reset() would keep
+     */
+    void release() noexcept {
+        check_redzones();
+        free_blocks(nullptr);
+        free_large();
+        pos_ = 0;
+        retired_used_ = 0;
+    }
+
+    /**
+     * @brief Get the number of bytes allocated since the last reset
+     */
+    size_t used() const noexcept {
+        return retired_used_ + pos_ + large_used_;
+    }
+
+    /**
+     * @brief Set the size above which requests bypass the blocks
+     *
+     * @param threshold Size in bytes; 0 restores the default of
+     *                  max(block_size() / 4, min_large_size)
+     */
+    void set_large_threshold(size_t threshold) noexcept {
+        large_threshold_ = threshold;
+    }
+
+    /**
+     * @brief Get the size above which requests get a dedicated mapping
+     *
+     * The default is floored so that a small (or adaptively shrunk) block
+     * does not send every medium request to mmap: the estimator ignores
+     * dedicated mappings, so it would never grow the block out of that.
+     */
+    size_t large_threshold() const noexcept {
+        return large_threshold_ != 0 ? large_threshold_ : std::max(block_size_ / 4, min_large_size);
+    }
+
+    /**
+     * @brief Get the number of live dedicated mappings
+     */
+    size_t large_count() const noexcept {
+        return large_count_;
+    }
+
+    /**
+     * @brief Get the total capacity of all blocks
+     */
+    size_t capacity() const noexcept {
+        return reserved_;
+    }
+
+    /**
+     * @brief Get the number of bytes left in the current block
+     */
+    size_t available() const noexcept {
+        return head_ != nullptr ? head_->capacity - pos_ : 0;
+    }
+
+    /**
+     * @brief Get the number of blocks currently held
+     */
+    size_t block_count() const noexcept {
+        return block_count_;
+    }
+
+    /**
+     * @brief Get the capacity the next new block will have
+     */
+    size_t block_size() const noexcept {
+        return block_size_;
+    }
+
+    /**
+     * @brief Get the allocation statistics (all zero unless built with QUANTA_ARENA_STATS)
+     *
+     * Large allocations count their whole mapping as consumed bytes and as
+     * a block. Safe to call from any thread while the owner allocates.
+     */
+    ArenaStats stats() const noexcept {
+        return stats_.snapshot();
+    }
+
+    /**
+     * @brief Get the estimator fed by reset() in adaptive mode
+     */
+    const CapacityEstimator& estimator() const noexcept {
+        return estimator_;
+    }
+
+    /**
+     * @brief Check if ptr belongs to any block of the arena
+     *
+     * @param ptr Pointer to check
+     */
+    bool owns(void* ptr) const noexcept {
+        for (Block* b = head_; b != nullptr; b = b->next) {
+            if (ptr >= b->data() && ptr < b->data() + b->capacity)
+                return true;
+        }
+        for (LargeBlock* l = large_; l != nullptr; l = l->next) {
+            char* start = reinterpret_cast<char*>(l);
+            if (ptr >= start + sizeof(LargeBlock) && ptr < start + l->mapped_size)
+                return true;
+        }
+        return false;
+    }
+
+private:
+    void* bump(size_t size, size_t alignment) noexcept {
+        char* data = head_->data();
+        uintptr_t base = reinterpret_cast<uintptr_t>(data);
+        size_t aligned_pos = align_up(base + pos_, alignment) - base;
+
+        if (aligned_pos < pos_ || aligned_pos > head_->capacity || size > head_->capacity - aligned_pos ||
+            debug::redzone > head_->capacity - aligned_pos - size)
+            return nullptr;
+
+        if constexpr (debug::enabled) {
+            debug::poison(data + pos_, aligned_pos - pos_);
+            debug::unpoison(data + aligned_pos, size);
+            debug::poison(data + aligned_pos + size, debug::redzone);
+            head_->redzones.push(data, aligned_pos + size);
+        }
+
+        size_t old_pos = pos_;
+        pos_ = aligned_pos + size + debug::redzone;
+        stats_.on_allocate(size, pos_ - old_pos, used());
+        return static_cast<void*>(data + aligned_pos);
+    }
+
+    bool add_block(size_t capacity) noexcept {
+        void* memory;
+        if constexpr (debug::guard_pages) {
+            // Map the block with a trailing guard page and stretch it up to the guard
+            size_t page = platform::page_size();
+            if (capacity > SIZE_MAX - sizeof(Block) - 2 * page) [[unlikely]]
+                return false;
+
+            size_t mapped = align_up(sizeof(Block) + capacity, page);
+            memory = platform::map_pages(mapped + page);
+            if (memory == nullptr) [[unlikely]]
+                return false;
+
+            if (!platform::make_inaccessible(static_cast<char*>(memory) + mapped, page)) {
+                platform::unmap_pages(memory, mapped + page);
+                return false;
+            }
+            capacity = mapped - sizeof(Block);
+        } else {
+            memory = ::operator new(sizeof(Block) + capacity, std::nothrow);
+            if (memory == nullptr) [[unlikely]]
+                return false;
+        }
+
+        Block* block = new (memory) Block{head_, capacity, {}};
+        debug::poison_untouched(block->data(), capacity);
+        if (head_ != nullptr)
+            retired_used_ += pos_;
+
+        head_ = block;
+        pos_ = 0;
+        ++block_count_;
+        stats_.on_block();
+        reserved_ += capacity;
+        return true;
+    }
+
+    void* allocate_large(size_t size, size_t alignment) noexcept {
+        size_t page = platform::page_size();
+        size_t offset = align_up(sizeof(LargeBlock), alignment);
+        if (size > SIZE_MAX - offset - page) [[unlikely]] {
+            stats_.on_failure();
+            return nullptr;
+        }
+
+        // Alignments beyond a page need slack to find an aligned start
+        size_t slack = alignment > page ? alignment - page : 0;
+        if (offset + size > SIZE_MAX - slack - page) [[unlikely]] {
+            stats_.on_failure();
+            return nullptr;
+        }
+        size_t mapped_size = align_up(offset + size + slack, page);
+
+        void* memory = platform::map_pages(mapped_size);
+        if (memory == nullptr) [[unlikely]] {
+            stats_.on_failure();
+            return nullptr;
+        }
+
+        uintptr_t base = reinterpret_cast<uintptr_t>(memory);
+        uintptr_t data = align_up(base + sizeof(LargeBlock), alignment);
+
+        LargeBlock* block = new (memory) LargeBlock{large_, mapped_size};
+        large_ = block;
+        large_used_ += size;
+        ++large_count_;
+        stats_.on_block();
+        stats_.on_allocate(size, mapped_size, used());
+        return reinterpret_cast<void*>(data);
+    }
+
+    void free_large() noexcept {
+        LargeBlock* l = large_;
+        while (l != nullptr) {
+            LargeBlock* next = l->next;
+            platform::unmap_pages(l, l->mapped_size);
+            l = next;
+        }
+
+        large_ = nullptr;
+        large_used_ = 0;
+        large_count_ = 0;
+    }
+
+    void check_redzones() const noexcept {
+        for (Block* b = head_; b != nullptr; b = b->next)
+            b->redzones.verify_all(b->data());
+    }
+
+    static void free_block(Block* block) noexcept {
+        debug::unpoison(block->data(), block->capacity);
+
+        if constexpr (debug::guard_pages) {
+            size_t page = platform::page_size();
+            platform::unmap_pages(block, sizeof(Block) + block->capacity + page);
+        } else {
+            ::operator delete(block);
+        }
+    }
+
+    // Free every block except keep, which becomes the only block
+    void free_blocks(Block* keep) noexcept {
+        Block* b = head_;
+        while (b != nullptr) {
+            Block* next = b->next;
+            if (b != keep)
+                free_block(b);
+            b = next;
+        }
+
+        head_ = keep;
+        block_count_ = keep != nullptr ? 1 : 0;
+        reserved_ = keep != nullptr ? keep->capacity : 0;
+        if (keep != nullptr)
+            keep->next = nullptr;
+    }
+};
+
+} // namespace quanta
@@ -0,0 +1,482 @@
+#pragma once
+
+#include "Common.hpp"
+#include "Composable.hpp"
+#include "Platform.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+    #include <fstream>
+    #include <sstream>
+#endif
+
+namespace quanta {
+
+namespace detail {
+
+// Minimal protocol buffer encoder, enough for the pprof profile.proto format
+class ProtoWriter {
+private:
+    std::string out_;
+
+public:
+    void varint(uint64_t value) {
+        while (value >= 0x80) {
+            out_.push_back(static_cast<char>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        out_.push_back(static_cast<char>(value));
+    }
+
+    void field_varint(uint32_t field, uint64_t value) {
+        varint(uint64_t{field} << 3 | 0);
+        varint(value);
+    }
+
+    void field_bytes(uint32_t field, std::string_view bytes) {
+        varint(uint64_t{field} << 3 | 2);
+        varint(bytes.size());
+        out_.append(bytes);
+    }
+
+    template<typename Range>
+    void field_packed(uint32_t field, const Range& values) {
+        ProtoWriter packed;
+        for (auto v : values)
+            packed.varint(static_cast<uint64_t>(v));
+        field_bytes(field, packed.str());
+    }
+
+    const std::string& str() const noexcept {
+        return out_;
+    }
+};
+
+} // namespace detail
+
+/**
+ * @brief Sampling allocation profiler that writes pprof profiles
+ *
+ * Instead of tracing every allocation, record() samples on average one
+ * allocation per sample_interval bytes (the gap is drawn from an
+ * exponential distribution, so periodic patterns cannot hide) and captures
+ * its stack. An allocation of size bytes is sampled with probability
+ * p = 1 - exp(-size / sample_interval), and each sample is weighted by 1/p
+ * (as 1/p objects and size/p bytes), so per-callsite totals are unbiased
+ * estimates of both the allocation count and the volume. The cost between
+ * samples is one atomic subtraction; when several threads run past the
+ * sampling point together, only the one whose allocation crossed it
+ * records a sample. A sample that cannot be stored because memory ran out
+ * is counted in dropped() instead of failing the allocation.
+ *
+ * Attach it with ProfilingAllocator, or call record() from any allocation
+ * path (e.g. next to ArenaPool::acquire()). write_pprof() produces a
+ * profile for `go tool pprof` / `pprof` with alloc_objects and alloc_space
+ * sample types; addresses are symbolized against the process mappings.
+ */
+class HeapProfiler {
+public:
+    static constexpr size_t default_interval = 512 * 1024;
+    static constexpr int max_frames = 32;
+    static constexpr int max_skip_frames = 8;
+
+private:
+    struct StackKey {
+        std::array<void*, max_frames> frames;
+        int depth;
+
+        bool operator==(const StackKey& other) const noexcept {
+            return depth == other.depth &&
+                   std::equal(frames.begin(), frames.begin() + depth, other.frames.begin());
+        }
+    };
+
+    struct StackHash {
+        size_t operator()(const StackKey& key) const noexcept {
+            uint64_t h = 1469598103934665603ull;
+            for (int i = 0; i < key.depth; ++i) {
+                h ^= reinterpret_cast<uintptr_t>(key.frames[i]);
+                h *= 1099511628211ull;
+            }
+            return static_cast<size_t>(h);
+        }
+    };
+
+    struct Totals {
+        double objects = 0;
+        double bytes = 0;
+    };
+
+    size_t interval_;
+    int skip_frames_;
+    std::atomic<int64_t> bytes_until_sample_;
+    std::atomic<uint64_t> samples_;
+    std::atomic<uint64_t> dropped_;
+    std::atomic<uint64_t> rng_;
+    std::mutex mutex_;
+    std::unordered_map<StackKey, Totals, StackHash> stacks_;    // guarded by mutex_
+
+public:
+
+    /**
+     * @brief Construct a profiler
+     *
+     * @param sample_interval Average bytes allocated between samples (1 samples everything)
+     * @param skip_frames Innermost frames to drop from each stack (the profiler's own, at most 8)
+     */
+    explicit HeapProfiler(size_t sample_interval = default_interval, int skip_frames = 2) noexcept
+        : interval_(std::max<size_t>(sample_interval, 1)),
+          skip_frames_(std::clamp(skip_frames, 0, max_skip_frames)),
+          bytes_until_sample_(0),
+          samples_(0),
+          dropped_(0),
+          rng_(0x9E3779B97F4A7C15ull ^ reinterpret_cast<uintptr_t>(this))
+    {
+        bytes_until_sample_.store(next_gap(), std::memory_order_relaxed);
+    }
+
+    HeapProfiler(const HeapProfiler&) = delete;
+    HeapProfiler& operator=(const HeapProfiler&) = delete;
+
+    /**
+     * @brief Account for an allocation of size bytes, sampling it if its turn has come
+     *
+     * Thread-safe.
+     */
+    void record(size_t size) noexcept {
+        int64_t before = bytes_until_sample_.fetch_sub(static_cast<int64_t>(size), std::memory_order_relaxed);
+        int64_t left = before - static_cast<int64_t>(size);
+        if (left > 0) [[likely]]
+            return;
+
+        // Only the allocation that crossed zero is sampled; ones that land
+        // before the counter is re-armed count towards the next gap
+        if (before > 0) {
+            rearm(left);
+            sample(size);
+        } else if (interval_ == 1) {
+            sample(size);
+        }
+    }
+
+    /**
+     * @brief Get the number of samples taken
+     */
+    uint64_t samples() const noexcept {
+        return samples_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Get the number of samples lost because their stack could not be stored
+     */
+    uint64_t dropped() const noexcept {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Get the number of distinct stacks sampled
+     */
+    size_t stack_count() noexcept {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return stacks_.size();
+    }
+
+    /**
+     * @brief Get the estimated total bytes allocated, summed over all stacks
+     */
+    uint64_t estimated_bytes() noexcept {
+        std::lock_guard<std::mutex> lock(mutex_);
+        double total = 0;
+        for (const auto& entry : stacks_)
+            total += entry.second.bytes;
+        return static_cast<uint64_t>(std::llround(total));
+    }
+
+    /**
+     * @brief Get the estimated number of allocations, summed over all stacks
+     */
+    uint64_t estimated_objects() noexcept {
+        std::lock_guard<std::mutex> lock(mutex_);
+        double total = 0;
+        for (const auto& entry : stacks_)
+            total += entry.second.objects;
+        return static_cast<uint64_t>(std::llround(total));
+    }
+
+    /**
+     * @brief Forget every sample
+     */
+    void clear() noexcept {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stacks_.clear();
+        samples_.store(0, std::memory_order_relaxed);
+        dropped_.store(0, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Write the samples as an uncompressed pprof protocol buffer
+     *
+     * @param path File to create or overwrite
+     * @return true if the whole profile was written
+     */
+    bool write_pprof(const char* path) {
+        std::string profile = encode_pprof();
+
+        std::FILE* file = std::fopen(path, "wb");
+        if (file == nullptr)
+            return false;
+        bool ok = std::fwrite(profile.data(), 1, profile.size(), file) == profile.size();
+        return std::fclose(file) == 0 && ok;
+    }
+
+    /**
+     * @brief Encode the samples in the pprof profile.proto format
+     */
+    std::string encode_pprof() {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        detail::ProtoWriter profile;
+        std::vector<std::string> strings{""};
+        std::unordered_map<std::string, uint64_t> string_ids{{"", 0}};
+        auto intern = [&](const std::string& s) -> uint64_t {
+            auto [it, inserted] = string_ids.try_emplace(s, strings.size());
+            if (inserted)
+                strings.push_back(s);
+            return it->second;
+        };
+
+        auto value_type = [&](const char* type, const char* unit) {
+            detail::ProtoWriter vt;
+            vt.field_varint(1, intern(type));
+            vt.field_varint(2, intern(unit));
+            return vt.str();
+        };
+
+        // Profile.sample_type
+        profile.field_bytes(1, value_type("alloc_objects", "count"));
+        profile.field_bytes(1, value_type("alloc_space", "bytes"));
+
+        // Profile.sample, with one Location per distinct address
+        std::unordered_map<uintptr_t, uint64_t> location_ids;
+        std::vector<uintptr_t> addresses;
+        for (const auto& [key, totals] : stacks_) {
+            std::vector<uint64_t> ids;
+            for (int i = 0; i < key.depth; ++i) {
+                uintptr_t address = reinterpret_cast<uintptr_t>(key.frames[i]);
+                auto [it, inserted] = location_ids.try_emplace(address, addresses.size() + 1);
+                if (inserted)
+                    addresses.push_back(address);
+                ids.push_back(it->second);
+            }
+
+            detail::ProtoWriter sample;
+            sample.field_packed(1, ids);
+            sample.field_packed(2, std::array<uint64_t, 2>{
+                static_cast<uint64_t>(std::llround(totals.objects)), static_cast<uint64_t>(std::llround(totals.bytes))});
+            profile.field_bytes(2, sample.str());
+        }
+
+        // Profile.mapping, so pprof can symbolize against the binaries
+        std::vector<Mapping> mappings = read_mappings();
+        for (size_t i = 0; i < mappings.size(); ++i) {
+            detail::ProtoWriter mapping;
+            mapping.field_varint(1, i + 1);
+            mapping.field_varint(2, mappings[i].start);
+            mapping.field_varint(3, mappings[i].limit);
+            mapping.field_varint(4, mappings[i].offset);
+            mapping.field_varint(5, intern(mappings[i].file));
+            profile.field_bytes(3, mapping.str());
+        }
+
+        // Profile.location and Profile.function (names the dynamic linker can resolve)
+        std::unordered_map<std::string, uint64_t> function_ids;
+        std::vector<std::string> functions;
+        for (size_t i = 0; i < addresses.size(); ++i) {
+            // Return addresses point after the call; step back into it
+            uintptr_t pc = addresses[i] > 0 ? addresses[i] - 1 : 0;
+
+            detail::ProtoWriter location;
+            location.field_varint(1, i + 1);
+            for (size_t m = 0; m < mappings.size(); ++m) {
+                if (pc >= mappings[m].start && pc < mappings[m].limit) {
+                    location.field_varint(2, m + 1);
+                    break;
+                }
+            }
+            location.field_varint(3, pc);
+
+            if (const char* name = platform::symbol_name(reinterpret_cast<void*>(pc))) {
+                auto [it, inserted] = function_ids.try_emplace(name, functions.size() + 1);
+                if (inserted)
+                    functions.push_back(name);
+
+                detail::ProtoWriter line;
+                line.field_varint(1, it->second);
+                location.field_bytes(4, line.str());
+            }
+            profile.field_bytes(4, location.str());
+        }
+
+        for (size_t i = 0; i < functions.size(); ++i) {
+            detail::ProtoWriter function;
+            function.field_varint(1, i + 1);
+            function.field_varint(2, intern(functions[i]));
+            function.field_varint(3, intern(functions[i]));
+            profile.field_bytes(5, function.str());
+        }
+
+        // Profile.time_nanos, period_type and period
+        uint64_t now = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
+        profile.field_varint(9, now);
+        profile.field_bytes(11, value_type("space", "bytes"));
+        profile.field_varint(12, interval_);
+
+        // Profile.string_table last: every string has been interned by now
+        for (const std::string& s : strings)
+            profile.field_bytes(6, s);
+
+        return profile.str();
+    }
+
+private:
+    struct Mapping {
+        uint64_t start;
+        uint64_t limit;
+        uint64_t offset;
+        std::string file;
+    };
+
+    // Executable mappings of the process (Linux only)
+    static std::vector<Mapping> read_mappings() {
+        std::vector<Mapping> mappings;
+#if defined(__linux__)
+        std::ifstream maps("/proc/self/maps");
+        std::string line;
+        while (std::getline(maps, line)) {
+            std::istringstream in(line);
+            std::string range, perms, offset, device, inode, file;
+            in >> range >> perms >> offset >> device >> inode >> file;
+            if (perms.size() < 3 || perms[2] != 'x' || file.empty() || file[0] != '/')
+                continue;
+
+            size_t dash = range.find('-');
+            if (dash == std::string::npos)
+                continue;
+            mappings.push_back({std::stoull(range.substr(0, dash), nullptr, 16),
+                                std::stoull(range.substr(dash + 1), nullptr, 16),
+                                std::stoull(offset, nullptr, 16), file});
+        }
+#endif
+        return mappings;
+    }
+
+    // Exponentially distributed gap with mean interval_ (splitmix64 over an atomic counter)
+    int64_t next_gap() noexcept {
+        if (interval_ == 1)
+            return 1;
+
+        uint64_t x = rng_.fetch_add(0x9E3779B97F4A7C15ull, std::memory_order_relaxed) + 0x9E3779B97F4A7C15ull;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+        x ^= x >> 31;
+        double u = (static_cast<double>(x >> 11) + 1.0) / 9007199254740993.0;     // (0, 1]
+        double gap = -std::log(u) * static_cast<double>(interval_);
+        return static_cast<int64_t>(std::min(gap, 1e15)) + 1;
+    }
+
+    // Inverse of the probability that an allocation of size bytes is sampled
+    double weight(size_t size) const noexcept {
+        if (interval_ == 1 || size == 0)
+            return 1.0;
+        return 1.0 / -std::expm1(-static_cast<double>(size) / static_cast<double>(interval_));
+    }
+
+    // Called by the thread whose allocation took the counter from above zero
+    // to left; the overshoot is inside the sampled allocation and is dropped,
+    // but bytes other threads subtracted since then stay charged.
+    void rearm(int64_t left) noexcept {
+        int64_t gap = next_gap();
+        int64_t current = bytes_until_sample_.load(std::memory_order_relaxed);
+        int64_t target;
+        do {
+            // Others allocated a whole gap meanwhile; start afresh rather than stall below zero
+            target = current - left + gap;
+            if (target <= 0)
+                target = gap;
+        } while (!bytes_until_sample_.compare_exchange_weak(current, target, std::memory_order_relaxed));
+    }
+
+    void sample(size_t size) noexcept {
+        StackKey key{};
+        void* frames[max_frames + max_skip_frames];
+        int depth = platform::capture_stack(frames, max_frames + skip_frames_);
+        int skip = std::min(skip_frames_, depth);
+        key.depth = std::min(depth - skip, max_frames);
+        std::copy(frames + skip, frames + skip + key.depth, key.frames.begin());
+
+        double w = weight(size);
+        std::lock_guard<std::mutex> lock(mutex_);
+        try {
+            Totals& totals = stacks_[key];
+            totals.objects += w;
+            totals.bytes += static_cast<double>(size) * w;
+        } catch (const std::bad_alloc&) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        samples_.fetch_add(1, std::memory_order_relaxed);
+    }
+};
+
+/**
+ * @brief Reports every allocation going through an allocator to a HeapProfiler
+ */
+template<Allocator A>
+class ProfilingAllocator {
+private:
+    A parent_;
+    HeapProfiler* profiler_;
+
+public:
+    ProfilingAllocator(A parent, HeapProfiler& profiler) noexcept
+        : parent_(std::move(parent)), profiler_(&profiler) {}
+
+    void* allocate(size_t size, size_t alignment) noexcept {
+        void* p = parent_.allocate(size, alignment);
+        if (p != nullptr)
+            profiler_->record(size);
+        return p;
+    }
+
+    void deallocate(void* ptr, size_t size) noexcept {
+        parent_.deallocate(ptr, size);
+    }
+
+    void reset() noexcept requires requires(A& a) { a.reset(); } {
+        parent_.reset();
+    }
+
+    bool owns(void* ptr) const noexcept requires OwningAllocator<A> {
+        return parent_.owns(ptr);
+    }
+
+    A& parent() noexcept { return parent_; }
+};
+
+} // namespace quanta
@@ -0,0 +1,177 @@
+#pragma once
+
+#include "Arena.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace quanta {
+
+/**
+ * @brief Pointer stored as the distance from its own address to the target
+ *
+ * Because the offset is relative to the pointer itself, a data structure
+ * linked with offset_ptr stays valid when the whole memory block is moved,
+ * saved to disk and mapped back elsewhere, or mapped at different addresses
+ * in several processes. Both the pointer and its target must live in the
+ * same block. Copying an offset_ptr re-targets the copy, so the pointee is
+ * preserved, not the raw offset.
+ *
+ * @tparam T Pointee type
+ */
+template<typename T>
+class offset_ptr {
+private:
+    // An offset of 1 can never reach a properly placed T from here, so it encodes null
+    static constexpr std::ptrdiff_t null_offset = 1;
+
+    std::ptrdiff_t offset_;
+
+public:
+    using element_type = T;
+
+    offset_ptr() noexcept : offset_(null_offset) {}
+    offset_ptr(std::nullptr_t) noexcept : offset_(null_offset) {}
+    offset_ptr(T* ptr) noexcept { set(ptr); }
+    offset_ptr(const offset_ptr& other) noexcept { set(other.get()); }
+
+    template<typename U, typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+    offset_ptr(const offset_ptr<U>& other) noexcept { set(other.get()); }
+
+    offset_ptr& operator=(const offset_ptr& other) noexcept {
+        set(other.get());
+        return *this;
+    }
+
+    offset_ptr& operator=(T* ptr) noexcept {
+        set(ptr);
+        return *this;
+    }
+
+    offset_ptr& operator=(std::nullptr_t) noexcept {
+        offset_ = null_offset;
+        return *this;
+    }
+
+    T* get() const noexcept {
+        if (offset_ == null_offset)
+            return nullptr;
+        return reinterpret_cast<T*>(reinterpret_cast<uintptr_t>(this) + static_cast<uintptr_t>(offset_));
+    }
+
+    T& operator*() const noexcept { return *get(); }
+    T* operator->() const noexcept { return get(); }
+    T& operator[](std::ptrdiff_t i) const noexcept { return get()[i]; }
+
+    explicit operator bool() const noexcept {
+        return offset_ != null_offset;
+    }
+
+    friend bool operator==(const offset_ptr& lhs, const offset_ptr& rhs) noexcept {
+        return lhs.get() == rhs.get();
+    }
+
+    friend bool operator==(const offset_ptr& lhs, const T* rhs) noexcept {
+        return lhs.get() == rhs;
+    }
+
+    friend bool operator==(const offset_ptr& lhs, std::nullptr_t) noexcept {
+        return !lhs;
+    }
+
+private:
+    void set(T* ptr) noexcept {
+        if (ptr == nullptr)
+            offset_ = null_offset;
+        else
+            offset_ = static_cast<std::ptrdiff_t>(reinterpret_cast<uintptr_t>(ptr) - reinterpret_cast<uintptr_t>(this));
+    }
+};
+
+/**
+ * @brief 4-byte link to an object inside an arena, stored as an offset from its base
+ *
+ * Half the size of a raw pointer, so node-based structures (trees, graphs,
+ * lists) built in an Arena of up to 4 GiB pack twice as many links per
+ * cache line. The base is not stored: resolve the pointer with get(arena)
+ * or get(base). Like offset_ptr it survives relocation and snapshots,
+ * since only the arena base changes.
+ *
+ * @tparam T Pointee type
+ */
+template<typename T>
+class arena_ptr32 {
+private:
+    static constexpr uint32_t null_offset = UINT32_MAX;
+
+    uint32_t offset_;
+
+    explicit arena_ptr32(uint32_t offset) noexcept : offset_(offset) {}
+
+public:
+    using element_type = T;
+
+    arena_ptr32() noexcept : offset_(null_offset) {}
+    arena_ptr32(std::nullptr_t) noexcept : offset_(null_offset) {}
+
+    /**
+     * @brief Encode ptr relative to base
+     *
+     * @param base Start of the arena memory
+     * @param ptr Object inside the arena, or nullptr
+     * @return The compressed pointer, or null if ptr is below base or 4 GiB or more past it
+     */
+    static arena_ptr32 from(const void* base, const T* ptr) noexcept {
+        uintptr_t b = reinterpret_cast<uintptr_t>(base);
+        uintptr_t p = reinterpret_cast<uintptr_t>(ptr);
+        if (ptr == nullptr || p < b || p - b >= null_offset)
+            return arena_ptr32();
+        return arena_ptr32(static_cast<uint32_t>(p - b));
+    }
+
+    /**
+     * @brief Encode ptr relative to the arena it was allocated from
+     */
+    static arena_ptr32 from(const Arena& arena, const T* ptr) noexcept {
+        return from(arena.data(), ptr);
+    }
+
+    /**
+     * @brief Decode against the base the pointer was encoded with
+     */
+    T* get(const void* base) const noexcept {
+        if (offset_ == null_offset)
+            return nullptr;
+        return reinterpret_cast<T*>(reinterpret_cast<uintptr_t>(base) + offset_);
+    }
+
+    /**
+     * @brief Decode against the arena the pointer was encoded with
+     */
+    T* get(const Arena& arena) const noexcept {
+        return get(arena.data());
+    }
+
+    /**
+     * @brief Get the raw offset from the arena base
+     */
+    uint32_t offset() const noexcept {
+        return offset_;
+    }
+
+    explicit operator bool() const noexcept {
+        return offset_ != null_offset;
+    }
+
+    friend bool operator==(arena_ptr32 lhs, arena_ptr32 rhs) noexcept {
+        return lhs.offset_ == rhs.offset_;
+    }
+
+    friend bool operator==(arena_ptr32 lhs, std::nullptr_t) noexcept {
+        return !lhs;
+    }
+};
+
+static_assert(sizeof(arena_ptr32<int>) == 4);
+
+} // namespace quanta
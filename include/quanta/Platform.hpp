@@ -0,0 +1,523 @@
+#pragma once
+
+#include "Common.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(_WIN32)
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    #if defined(__has_include)
+        #if __has_include(<execinfo.h>)
+            #include <execinfo.h>
+            #define QUANTA_HAS_EXECINFO 1
+        #endif
+        #if __has_include(<dlfcn.h>)
+            #include <dlfcn.h>
+            #define QUANTA_HAS_DLADDR 1
+        #endif
+    #endif
+    #include <cerrno>
+    #include <fcntl.h>
+    #include <signal.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace quanta::platform {
+
+/**
+ * @brief Get the virtual memory page size
+ */
+inline size_t page_size() noexcept {
+#if defined(_WIN32)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return static_cast<size_t>(info.dwPageSize);
+#else
+    static const size_t size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    return size;
+#endif
+}
+
+/**
+ * @brief Map zero-filled, read-write pages directly from the OS
+ *
+ * @param size Number of bytes to map (rounded up to whole pages by the OS)
+ * @return Page-aligned pointer or nullptr on failure
+ */
+inline void* map_pages(size_t size) noexcept {
+#if defined(_WIN32)
+    return VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#else
+    void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    return p == MAP_FAILED ? nullptr : p;
+#endif
+}
+
+/**
+ * @brief Return pages obtained from map_pages()
+ *
+ * @param ptr Pointer returned by map_pages()
+ * @param size Size passed to map_pages()
+ */
+inline void unmap_pages(void* ptr, size_t size) noexcept {
+#if defined(_WIN32)
+    (void)size;
+    VirtualFree(ptr, 0, MEM_RELEASE);
+#else
+    munmap(ptr, size);
+#endif
+}
+
+/**
+ * @brief Change the access rights of whole pages
+ *
+ * @param ptr Page-aligned start of the range
+ * @param size Number of bytes (rounded up to whole pages)
+ * @param writable Read-write if true, read-only otherwise
+ * @return true on success
+ */
+inline bool protect_pages(void* ptr, size_t size, bool writable) noexcept {
+#if defined(_WIN32)
+    DWORD old;
+    return VirtualProtect(ptr, size, writable ? PAGE_READWRITE : PAGE_READONLY, &old) != 0;
+#else
+    return mprotect(ptr, size, writable ? (PROT_READ | PROT_WRITE) : PROT_READ) == 0;
+#endif
+}
+
+/**
+ * @brief Turn whole pages into guard pages that fault on any access
+ *
+ * @param ptr Page-aligned start of the range
+ * @param size Number of bytes (rounded up to whole pages)
+ * @return true on success
+ */
+inline bool make_inaccessible(void* ptr, size_t size) noexcept {
+#if defined(_WIN32)
+    DWORD old;
+    return VirtualProtect(ptr, size, PAGE_NOACCESS, &old) != 0;
+#else
+    return mprotect(ptr, size, PROT_NONE) == 0;
+#endif
+}
+
+/**
+ * @brief A file mapped at the start of a larger writable reservation
+ */
+struct FileMapping {
+    void* base = nullptr;       // nullptr on failure
+    size_t size = 0;            // whole reservation, a multiple of the page size
+    size_t file_size = 0;       // file bytes mapped at base
+};
+
+/**
+ * @brief Map a file privately and reserve anonymous pages after it
+ *
+ * The file pages are shared with the page cache (and with other processes
+ * mapping the same file) until written. In read-only mode writing to them
+ * faults; in copy-on-write mode writes stay private to this mapping.
+ *
+ * @param path File to map
+ * @param min_size Minimum size of the whole reservation in bytes
+ * @param writable Whether the file pages are copy-on-write instead of read-only
+ * @param offset Start of the mapped part of the file (must be page-aligned)
+ * @return The mapping, with base == nullptr on failure or when unsupported
+ */
+inline FileMapping map_file(const char* path, size_t min_size, bool writable, size_t offset = 0) noexcept {
+#if defined(_WIN32)
+    (void)path; (void)min_size; (void)writable; (void)offset;
+    return {};
+#else
+    size_t page = page_size();
+    if (offset % page != 0)
+        return {};
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return {};
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < offset) {
+        close(fd);
+        return {};
+    }
+
+    size_t file_size = static_cast<size_t>(st.st_size) - offset;
+    size_t size = align_up(std::max({min_size, file_size, size_t{1}}), page);
+
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#ifdef MAP_NORESERVE
+    flags |= MAP_NORESERVE;
+#endif
+    void* base = mmap(nullptr, size, PROT_READ | PROT_WRITE, flags, -1, 0);
+    if (base == MAP_FAILED) {
+        close(fd);
+        return {};
+    }
+
+    if (file_size > 0) {
+        int prot = writable ? (PROT_READ | PROT_WRITE) : PROT_READ;
+        void* p = mmap(base, file_size, prot, MAP_PRIVATE | MAP_FIXED, fd, static_cast<off_t>(offset));
+        if (p == MAP_FAILED) {
+            munmap(base, size);
+            close(fd);
+            return {};
+        }
+    }
+
+    close(fd);
+    return {base, size, file_size};
+#endif
+}
+
+/**
+ * @brief Get the id of the calling process
+ */
+inline int32_t current_process_id() noexcept {
+#if defined(_WIN32)
+    return static_cast<int32_t>(GetCurrentProcessId());
+#else
+    return static_cast<int32_t>(getpid());
+#endif
+}
+
+/**
+ * @brief Check whether a process still exists
+ */
+inline bool process_alive(int32_t pid) noexcept {
+#if defined(_WIN32)
+    HANDLE process = OpenProcess(SYNCHRONIZE, FALSE, static_cast<DWORD>(pid));
+    if (process == nullptr)
+        return false;
+    bool alive = WaitForSingleObject(process, 0) == WAIT_TIMEOUT;
+    CloseHandle(process);
+    return alive;
+#else
+    // EPERM means the process exists but belongs to someone else
+    return kill(static_cast<pid_t>(pid), 0) == 0 || errno == EPERM;
+#endif
+}
+
+/**
+ * @brief Identifies one process incarnation, not just a (reusable) pid
+ */
+struct ProcessIdentity {
+    int32_t pid = 0;
+    uint64_t start_time = 0;        // OS start timestamp; 0 when the platform has none
+    uint64_t pid_namespace = 0;     // pid namespace id (Linux); 0 when unknown
+};
+
+/**
+ * @brief What process_state() can tell about a recorded identity
+ */
+enum class ProcessState {
+    Alive,
+    Dead,       // gone, or its pid now belongs to a later process
+    Unknown,    // in another pid namespace: its pid means nothing here
+};
+
+namespace detail {
+
+#if defined(__linux__)
+// Field 22 of /proc/<pid>/stat, in clock ticks since boot; 0 if there is no such process
+inline uint64_t linux_start_time(int32_t pid) noexcept {
+    char path[64];
+    std::snprintf(path, sizeof(path), "/proc/%d/stat", static_cast<int>(pid));
+    int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return 0;
+
+    char buffer[1024];
+    ssize_t n = ::read(fd, buffer, sizeof(buffer) - 1);
+    close(fd);
+    if (n <= 0)
+        return 0;
+    buffer[n] = '\0';
+
+    // The command name may contain spaces and parentheses: fields restart after the last ')'
+    const char* p = nullptr;
+    for (const char* c = buffer; *c != '\0'; ++c) {
+        if (*c == ')')
+            p = c;
+    }
+    if (p == nullptr)
+        return 0;
+
+    for (int field = 2; field < 22 && p != nullptr; ++field) {
+        p = std::strchr(p + 1, ' ');
+    }
+    return p != nullptr ? std::strtoull(p + 1, nullptr, 10) : 0;
+}
+
+inline uint64_t linux_pid_namespace() noexcept {
+    struct stat st;
+    return ::stat("/proc/self/ns/pid", &st) == 0 ? static_cast<uint64_t>(st.st_ino) : 0;
+}
+#endif
+
+#if defined(_WIN32)
+inline uint64_t windows_start_time(int32_t pid) noexcept {
+    HANDLE process = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, static_cast<DWORD>(pid));
+    if (process == nullptr)
+        return 0;
+    FILETIME created, exited, kernel, user;
+    uint64_t start = 0;
+    if (GetProcessTimes(process, &created, &exited, &kernel, &user))
+        start = (static_cast<uint64_t>(created.dwHighDateTime) << 32) | created.dwLowDateTime;
+    CloseHandle(process);
+    return start;
+}
+#endif
+
+} // namespace detail
+
+/**
+ * @brief Get the identity of a process as seen from the calling process
+ *
+ * @param pid Process id in the caller's pid namespace
+ */
+inline ProcessIdentity process_identity(int32_t pid) noexcept {
+    ProcessIdentity id;
+    id.pid = pid;
+#if defined(__linux__)
+    id.start_time = detail::linux_start_time(pid);
+    id.pid_namespace = detail::linux_pid_namespace();
+#elif defined(_WIN32)
+    id.start_time = detail::windows_start_time(pid);
+#endif
+    return id;
+}
+
+/**
+ * @brief Get the identity of the calling process
+ */
+inline ProcessIdentity current_process_identity() noexcept {
+    return process_identity(current_process_id());
+}
+
+/**
+ * @brief Check whether the process an identity was taken from still runs
+ *
+ * Unlike process_alive(), a pid reused by a later process reports Dead, as
+ * the start time no longer matches. Without start times (platforms other
+ * than Linux and Windows) this falls back to process_alive() and cannot
+ * see reuse.
+ */
+inline ProcessState process_state(const ProcessIdentity& id) noexcept {
+    if (id.pid <= 0)
+        return ProcessState::Dead;
+
+#if defined(__linux__)
+    if (id.pid_namespace != 0 && id.pid_namespace != detail::linux_pid_namespace())
+        return ProcessState::Unknown;
+#endif
+
+    if (id.start_time != 0) {
+        ProcessIdentity now = process_identity(id.pid);
+        if (now.start_time != 0)
+            return now.start_time == id.start_time ? ProcessState::Alive : ProcessState::Dead;
+        // No start time readable (e.g. /proc not mounted): only liveness is left
+    }
+    return process_alive(id.pid) ? ProcessState::Alive : ProcessState::Dead;
+}
+
+/**
+ * @brief Capture the return addresses of the calling thread's stack
+ *
+ * @param frames Receives up to max_frames addresses, innermost first
+ * @param max_frames Capacity of frames
+ * @return Number of addresses captured (0 when unsupported)
+ */
+inline int capture_stack(void** frames, int max_frames) noexcept {
+#if defined(_WIN32)
+    return static_cast<int>(CaptureStackBackTrace(0, static_cast<DWORD>(max_frames), frames, nullptr));
+#elif defined(QUANTA_HAS_EXECINFO)
+    return backtrace(frames, max_frames);
+#else
+    (void)frames; (void)max_frames;
+    return 0;
+#endif
+}
+
+/**
+ * @brief Name of the symbol containing an address, if the dynamic linker knows it
+ *
+ * @return The mangled name, or nullptr (static functions need -rdynamic to be found)
+ */
+inline const char* symbol_name(const void* address) noexcept {
+#if defined(QUANTA_HAS_DLADDR)
+    Dl_info info;
+    if (dladdr(address, &info) != 0)
+        return info.dli_sname;
+#endif
+    (void)address;
+    return nullptr;
+}
+
+/**
+ * @brief Memory mapped shared (MAP_SHARED) between processes
+ */
+struct SharedMapping {
+    void* base = nullptr;       // nullptr on failure
+    size_t size = 0;            // mapped bytes
+    int fd = -1;                // kept open for anonymous memory so it can be passed on
+};
+
+#if !defined(_WIN32)
+namespace detail {
+
+inline SharedMapping map_shared_fd(int fd, size_t size) noexcept {
+    void* base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED)
+        return {};
+    return {base, size, -1};
+}
+
+} // namespace detail
+#endif
+
+/**
+ * @brief Create zero-filled shared memory
+ *
+ * With a name, a POSIX shared memory object is created (it must not exist
+ * yet) and other processes attach with open_shared(). Without a name the
+ * memory is anonymous (memfd_create on Linux) and is shared by passing the
+ * returned descriptor, e.g. across fork() or over a Unix socket.
+ *
+ * @param name Name starting with '/', or nullptr for anonymous memory
+ * @param size Number of bytes, rounded up to whole pages
+ * @return The mapping, with base == nullptr on failure or when unsupported
+ */
+inline SharedMapping create_shared(const char* name, size_t size) noexcept {
+#if defined(_WIN32)
+    (void)name; (void)size;
+    return {};
+#else
+    size = align_up(std::max(size, size_t{1}), page_size());
+
+    int fd = -1;
+    if (name != nullptr) {
+        fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+    } else {
+#if defined(__linux__)
+        fd = memfd_create("quanta-shared", MFD_CLOEXEC);
+#else
+        // No memfd: use a private name and unlink it right away
+        char tmp[64];
+        std::snprintf(tmp, sizeof(tmp), "/quanta-%ld-%p", static_cast<long>(getpid()), static_cast<void*>(&tmp));
+        fd = shm_open(tmp, O_RDWR | O_CREAT | O_EXCL, 0600);
+        if (fd >= 0)
+            shm_unlink(tmp);
+#endif
+    }
+    if (fd < 0)
+        return {};
+
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        close(fd);
+        if (name != nullptr)
+            shm_unlink(name);
+        return {};
+    }
+
+    SharedMapping mapping = detail::map_shared_fd(fd, size);
+    if (mapping.base == nullptr || name != nullptr) {
+        close(fd);
+        if (mapping.base == nullptr && name != nullptr)
+            shm_unlink(name);
+        return mapping;
+    }
+
+    mapping.fd = fd;
+    return mapping;
+#endif
+}
+
+/**
+ * @brief Map existing shared memory, by name or by descriptor
+ *
+ * @param name Name passed to create_shared(), or nullptr to use fd
+ * @param fd Descriptor of anonymous shared memory (duplicated, not adopted)
+ * @return The mapping of the whole object, with base == nullptr on failure
+ */
+inline SharedMapping open_shared(const char* name, int fd = -1) noexcept {
+#if defined(_WIN32)
+    (void)name; (void)fd;
+    return {};
+#else
+    int own = name != nullptr ? shm_open(name, O_RDWR, 0) : fcntl(fd, F_DUPFD_CLOEXEC, 0);
+    if (own < 0)
+        return {};
+
+    struct stat st;
+    if (fstat(own, &st) != 0 || st.st_size <= 0) {
+        close(own);
+        return {};
+    }
+
+    SharedMapping mapping = detail::map_shared_fd(own, static_cast<size_t>(st.st_size));
+    if (mapping.base == nullptr || name != nullptr)
+        close(own);
+    else
+        mapping.fd = own;
+    return mapping;
+#endif
+}
+
+/**
+ * @brief Map shared memory copy-on-write
+ *
+ * The mapping starts out with the current contents of the memory. Pages
+ * written through it become private copies; pages not yet written keep
+ * reflecting changes made through shared mappings.
+ *
+ * @param fd Descriptor from create_shared()
+ * @param size Number of bytes to map
+ * @return Page-aligned pointer (release with unmap_pages()) or nullptr on failure
+ */
+inline void* map_private(int fd, size_t size) noexcept {
+#if defined(_WIN32)
+    (void)fd; (void)size;
+    return nullptr;
+#else
+    void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    return p == MAP_FAILED ? nullptr : p;
+#endif
+}
+
+/**
+ * @brief Unmap shared memory and close its descriptor
+ */
+inline void close_shared(SharedMapping& mapping) noexcept {
+#if !defined(_WIN32)
+    if (mapping.base != nullptr)
+        munmap(mapping.base, mapping.size);
+    if (mapping.fd >= 0)
+        close(mapping.fd);
+#endif
+    mapping = {};
+}
+
+/**
+ * @brief Remove a named shared memory object; existing mappings stay valid
+ */
+inline bool unlink_shared(const char* name) noexcept {
+#if defined(_WIN32)
+    (void)name;
+    return false;
+#else
+    return shm_unlink(name) == 0;
+#endif
+}
+
+} // namespace quanta::platform
@@ -0,0 +1,315 @@
+#pragma once
+
+#include "Common.hpp"
+#include "Platform.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace quanta {
+
+/**
+ * @brief Bump allocator in shared memory that several processes map at once
+ *
+ * The bump pointer lives in a header at the start of the shared memory and
+ * is advanced with compare-and-swap, so every process (and thread) attached
+ * to the arena can allocate concurrently. Each process maps the memory at a
+ * different address: exchange Handle values (offsets from the start of the
+ * memory), never raw pointers, and resolve them locally with get().
+ *
+ * A producer can build a message in place and publish its handle with
+ * set_root() or through any other channel; the consumer reads the bytes
+ * where they are, without copying.
+ */
+class SharedArena {
+public:
+    /**
+     * @brief Position of an allocation, valid in every process attached to the arena
+     */
+    struct Handle {
+        uint64_t offset = 0;    // 0 is the header, so it doubles as null
+
+        explicit operator bool() const noexcept { return offset != 0; }
+        friend bool operator==(Handle, Handle) = default;
+    };
+
+private:
+    struct Header {
+        static constexpr uint64_t expected_magic = 0x414E455241485351ull;     // "QSHARENA"
+
+        uint64_t magic;
+        uint64_t size;                  // total bytes including the header
+        std::atomic<uint64_t> pos;      // bump pointer, offset from the header
+        std::atomic<uint64_t> root;     // handle published with set_root()
+    };
+
+    static_assert(std::atomic<uint64_t>::is_always_lock_free,
+                  "shared memory needs address-free (lock-free) atomics");
+
+    static constexpr size_t data_offset = 64;   // first allocation starts on its own cache line
+    static_assert(sizeof(Header) <= data_offset);
+
+    platform::SharedMapping mapping_;
+
+public:
+
+    /**
+     * @brief Construct an empty, detached arena
+     */
+    SharedArena() noexcept = default;
+
+    ~SharedArena() {
+        platform::close_shared(mapping_);
+    }
+
+    // Each object owns one mapping; attach again with open() instead of copying
+    SharedArena(const SharedArena&) = delete;
+    SharedArena& operator=(const SharedArena&) = delete;
+
+    SharedArena(SharedArena&& other) noexcept
+        : mapping_(std::exchange(other.mapping_, {}))
+    {    }
+
+    SharedArena& operator=(SharedArena&& other) noexcept {
+        if (this != &other) {
+            platform::close_shared(mapping_);
+            mapping_ = std::exchange(other.mapping_, {});
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Create a named arena that other processes attach to with open()
+     *
+     * The name stays reserved until unlink() is called.
+     *
+     * @param name Shared memory name starting with '/' (must not exist yet)
+     * @param capacity Total size in bytes, header included
+     * @return The arena, or a detached arena on failure
+     */
+    static SharedArena create(const char* name, size_t capacity) noexcept {
+        return init(platform::create_shared(name, capacity));
+    }
+
+    /**
+     * @brief Create an unnamed arena shared by passing fd() to other processes
+     *
+     * The descriptor survives fork() and can be sent over a Unix socket;
+     * the memory is freed once every mapping and descriptor is gone.
+     *
+     * @param capacity Total size in bytes, header included
+     * @return The arena, or a detached arena on failure
+     */
+    static SharedArena create_anonymous(size_t capacity) noexcept {
+        return init(platform::create_shared(nullptr, capacity));
+    }
+
+    /**
+     * @brief Attach to an arena created with create()
+     *
+     * @param name Name passed to create()
+     * @return The arena, or a detached arena if it does not exist or is not an arena
+     */
+    static SharedArena open(const char* name) noexcept {
+        return attach(platform::open_shared(name));
+    }
+
+    /**
+     * @brief Attach to an anonymous arena through its descriptor
+     *
+     * @param fd Descriptor from fd() of another SharedArena (it is duplicated)
+     * @return The arena, or a detached arena on failure
+     */
+    static SharedArena open_fd(int fd) noexcept {
+        return attach(platform::open_shared(nullptr, fd));
+    }
+
+    /**
+     * @brief Remove a named arena; processes already attached keep their mapping
+     */
+    static bool unlink(const char* name) noexcept {
+        return platform::unlink_shared(name);
+    }
+
+    /**
+     * @brief Allocate memory visible to every attached process
+     *
+     * Safe to call concurrently from any thread of any attached process.
+     *
+     * @param size Number of bytes to allocate
+     * @param alignment Alignment requirement (power of 2, at most the page size)
+     * @return Pointer in this process's mapping or nullptr if out of space
+     */
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t)) noexcept {
+        if (mapping_.base == nullptr || !is_power_of_2(alignment) || alignment > platform::page_size())
+            return nullptr;
+
+        // The mapping is page-aligned in every process, so aligning the offset aligns the address
+        Header* h = header();
+        uint64_t pos = h->pos.load(std::memory_order_relaxed);
+        uint64_t aligned;
+        do {
+            aligned = align_up(pos, alignment);
+            if (aligned > h->size || size > h->size - aligned)
+                return nullptr;
+        } while (!h->pos.compare_exchange_weak(pos, aligned + size,
+                                               std::memory_order_relaxed, std::memory_order_relaxed));
+
+        return base() + aligned;
+    }
+
+    /**
+     * @brief Type-safe allocation for objects of type T
+     */
+    template<typename T>
+    T* allocate(size_t count = 1) noexcept {
+        if (count > SIZE_MAX / sizeof(T))
+            return nullptr;
+
+        return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    /**
+     * @brief Get the process-independent handle of a pointer into the arena
+     *
+     * @return The handle, or a null handle if ptr is not in the arena
+     */
+    Handle handle(const void* ptr) const noexcept {
+        if (!owns(ptr))
+            return Handle{};
+        return Handle{static_cast<uint64_t>(static_cast<const char*>(ptr) - base())};
+    }
+
+    /**
+     * @brief Resolve a handle in this process's mapping
+     *
+     * @return The pointer, or nullptr for a null or out-of-range handle
+     */
+    void* get(Handle handle) const noexcept {
+        if (!handle || handle.offset < data_offset || handle.offset >= mapping_.size)
+            return nullptr;
+        return base() + handle.offset;
+    }
+
+    template<typename T>
+    T* get(Handle handle) const noexcept {
+        return static_cast<T*>(get(handle));
+    }
+
+    /**
+     * @brief Publish a handle for other processes to pick up with root()
+     *
+     * Release ordering: everything written to the arena before set_root()
+     * is visible to a process that reads the handle with root().
+     */
+    void set_root(Handle handle) noexcept {
+        if (mapping_.base != nullptr)
+            header()->root.store(handle.offset, std::memory_order_release);
+    }
+
+    /**
+     * @brief Get the handle last published with set_root()
+     */
+    Handle root() const noexcept {
+        if (mapping_.base == nullptr)
+            return Handle{};
+        return Handle{header()->root.load(std::memory_order_acquire)};
+    }
+
+    /**
+     * @brief Reset the arena for every attached process
+     *
+     * No process may still use earlier allocations.
+     */
+    void reset() noexcept {
+        if (mapping_.base == nullptr)
+            return;
+        header()->root.store(0, std::memory_order_relaxed);
+        header()->pos.store(data_offset, std::memory_order_release);
+    }
+
+    /**
+     * @brief Get the number of bytes allocated by all processes
+     */
+    size_t used() const noexcept {
+        if (mapping_.base == nullptr)
+            return 0;
+        return static_cast<size_t>(header()->pos.load(std::memory_order_relaxed)) - data_offset;
+    }
+
+    /**
+     * @brief Get the number of bytes available to allocations
+     */
+    size_t capacity() const noexcept {
+        return mapping_.base != nullptr ? mapping_.size - data_offset : 0;
+    }
+
+    /**
+     * @brief Get the number of bytes still free
+     */
+    size_t available() const noexcept {
+        return capacity() - used();
+    }
+
+    /**
+     * @brief Get the descriptor of an anonymous arena (-1 for named arenas)
+     */
+    int fd() const noexcept {
+        return mapping_.fd;
+    }
+
+    /**
+     * @brief Check whether the arena is attached to shared memory
+     */
+    explicit operator bool() const noexcept {
+        return mapping_.base != nullptr;
+    }
+
+    /**
+     * @brief Check if ptr points into this process's mapping of the arena
+     */
+    bool owns(const void* ptr) const noexcept {
+        const char* p = static_cast<const char*>(ptr);
+        return mapping_.base != nullptr && p >= base() + data_offset && p < base() + mapping_.size;
+    }
+
+private:
+    char* base() const noexcept {
+        return static_cast<char*>(mapping_.base);
+    }
+
+    Header* header() const noexcept {
+        return static_cast<Header*>(mapping_.base);
+    }
+
+    static SharedArena init(platform::SharedMapping mapping) noexcept {
+        SharedArena arena;
+        arena.mapping_ = mapping;
+        if (mapping.base == nullptr || mapping.size <= data_offset) {
+            platform::close_shared(arena.mapping_);
+            return arena;
+        }
+
+        // Fresh shared memory is zero-filled, so the atomics start out valid
+        Header* h = arena.header();
+        h->size = mapping.size;
+        h->pos.store(data_offset, std::memory_order_relaxed);
+        h->root.store(0, std::memory_order_relaxed);
+        std::atomic_ref<uint64_t>(h->magic).store(Header::expected_magic, std::memory_order_release);
+        return arena;
+    }
+
+    static SharedArena attach(platform::SharedMapping mapping) noexcept {
+        SharedArena arena;
+        arena.mapping_ = mapping;
+        if (mapping.base == nullptr || mapping.size <= data_offset ||
+            std::atomic_ref<uint64_t>(arena.header()->magic).load(std::memory_order_acquire) != Header::expected_magic ||
+            arena.header()->size != mapping.size) {
+            platform::close_shared(arena.mapping_);
+        }
+        return arena;
+    }
+};
+
+} // namespace quanta
@@ -0,0 +1,571 @@
+#pragma once
+
+#include "Common.hpp"
+#include "Platform.hpp"
+#include "SharedArena.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace quanta {
+
+/**
+ * @brief Fixed-size blocks in shared memory, allocated and freed by any process
+ *
+ * The free list is a lock-free stack of block indices kept in the shared
+ * header, with a tag in the upper half of the head word against ABA. It
+ * holds indices rather than pointers, so it is valid in every mapping.
+ * Each block records the process that owns it; when a process dies without
+ * freeing its blocks, recover() returns them to the pool. Blocks handed to
+ * another process should be passed on with transfer(), so that a crash of
+ * the producer does not reclaim a block the consumer still reads.
+ *
+ * Owners are kept in a table of process identities in the shared header:
+ * pid, start time and (on Linux) pid namespace. A pid reused by a later
+ * process therefore does not keep a dead owner's blocks alive, and a pid
+ * from another namespace is never mistaken for a local one. Limits:
+ *  - owners in another pid namespace cannot be checked from here, so their
+ *    blocks are only recovered by a process in the same namespace
+ *  - on platforms without process start times (not Linux or Windows) only
+ *    pid liveness is checked, so pid reuse keeps a dead owner's blocks
+ *  - at most max_processes identities are tracked at once; blocks taken
+ *    while the table is full are never recovered, but the process joins
+ *    the table on a later allocation once recover() has freed an entry
+ *  - a process dying inside allocate() or deallocate(), between the free
+ *    list and the owner word, leaks that one block
+ *
+ * As with SharedArena, exchange Handle values between processes and resolve
+ * them with get().
+ */
+class SharedPool {
+public:
+    using Handle = SharedArena::Handle;
+
+private:
+    static constexpr uint32_t npos = UINT32_MAX;
+    static constexpr size_t block_alignment = 64;   // blocks never share a cache line
+
+public:
+    static constexpr uint32_t max_processes = 256;
+
+private:
+    // Owner words name a process table entry and the generation it was claimed
+    // in: (generation << 9) | (entry + 1). 0 is a free block.
+    static constexpr uint32_t entry_bits = 9;
+    static constexpr uint32_t generation_mask = UINT32_MAX >> entry_bits;
+    static constexpr uint32_t untracked = UINT32_MAX;   // process table was full
+
+    // Process table entry states, in the low bits of Process::state
+    static constexpr uint32_t entry_free = 0;
+    static constexpr uint32_t entry_claiming = 1;
+    static constexpr uint32_t entry_live = 2;
+
+    struct Header {
+        static constexpr uint64_t expected_magic = 0x4C4F4F5048535155ull;     // "QUSHPOOL"
+
+        uint64_t magic;
+        uint64_t size;                      // total mapped bytes
+        uint64_t block_size;                // usable bytes per block
+        uint64_t stride;                    // distance between blocks
+        uint64_t blocks_offset;             // offset of block 0
+        uint32_t block_count;
+        std::atomic<uint32_t> free_count;
+        std::atomic<uint64_t> head;         // (tag << 32) | block index
+    };
+
+    struct Process {
+        std::atomic<uint32_t> state;        // (generation << 2) | entry_*
+        std::atomic<int32_t> pid;
+        std::atomic<uint64_t> start_time;
+        std::atomic<uint64_t> pid_namespace;
+    };
+
+    struct BlockState {
+        std::atomic<uint32_t> next;         // free-list link
+        std::atomic<uint32_t> owner;        // owner word, 0 while free
+    };
+
+    static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free,
+                  "shared memory needs address-free (lock-free) atomics");
+    static_assert(sizeof(Header) <= block_alignment);
+    static_assert(max_processes < (1u << entry_bits));
+
+    platform::SharedMapping mapping_;
+    std::atomic<uint64_t> self_{0};         // (pid << 32) | owner word of this process
+
+public:
+
+    /**
+     * @brief Construct an empty, detached pool
+     */
+    SharedPool() noexcept = default;
+
+    ~SharedPool() {
+        platform::close_shared(mapping_);
+    }
+
+    SharedPool(const SharedPool&) = delete;
+    SharedPool& operator=(const SharedPool&) = delete;
+
+    SharedPool(SharedPool&& other) noexcept
+        : mapping_(std::exchange(other.mapping_, {})),
+          self_(other.self_.exchange(0, std::memory_order_relaxed))
+    {    }
+
+    SharedPool& operator=(SharedPool&& other) noexcept {
+        if (this != &other) {
+            platform::close_shared(mapping_);
+            mapping_ = std::exchange(other.mapping_, {});
+            self_.store(other.self_.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Create a named pool that other processes attach to with open()
+     *
+     * @param name Shared memory name starting with '/' (must not exist yet)
+     * @param block_size Usable bytes per block
+     * @param block_count Number of blocks
+     * @return The pool, or a detached pool on failure
+     */
+    static SharedPool create(const char* name, size_t block_size, size_t block_count) noexcept {
+        size_t size = required_size(block_size, block_count);
+        if (size == 0)
+            return SharedPool();
+        return init(platform::create_shared(name, size), block_size, block_count);
+    }
+
+    /**
+     * @brief Create an unnamed pool shared by passing fd() to other processes
+     */
+    static SharedPool create_anonymous(size_t block_size, size_t block_count) noexcept {
+        size_t size = required_size(block_size, block_count);
+        if (size == 0)
+            return SharedPool();
+        return init(platform::create_shared(nullptr, size), block_size, block_count);
+    }
+
+    /**
+     * @brief Attach to a pool created with create()
+     */
+    static SharedPool open(const char* name) noexcept {
+        return attach(platform::open_shared(name));
+    }
+
+    /**
+     * @brief Attach to an anonymous pool through its descriptor (it is duplicated)
+     */
+    static SharedPool open_fd(int fd) noexcept {
+        return attach(platform::open_shared(nullptr, fd));
+    }
+
+    /**
+     * @brief Remove a named pool; processes already attached keep their mapping
+     */
+    static bool unlink(const char* name) noexcept {
+        return platform::unlink_shared(name);
+    }
+
+    /**
+     * @brief Take a block, owned by the calling process
+     *
+     * @return Pointer to block_size() bytes, or nullptr if the pool is empty
+     */
+    void* allocate() noexcept {
+        if (mapping_.base == nullptr)
+            return nullptr;
+
+        uint32_t index = pop();
+        if (index == npos)
+            return nullptr;
+
+        state(index).owner.store(self_word(), std::memory_order_relaxed);
+        return block(index);
+    }
+
+    /**
+     * @brief Sized allocation for composition; fails for requests larger than a block
+     */
+    void* allocate(size_t size, size_t alignment) noexcept {
+        if (mapping_.base == nullptr || !is_power_of_2(alignment) || alignment > block_alignment ||
+            size == 0 || size > block_size())
+            return nullptr;
+        return allocate();
+    }
+
+    /**
+     * @brief Return a block to the pool; any attached process may free it
+     *
+     * @param ptr Pointer returned by allocate() or get() (nullptr and double frees are ignored)
+     */
+    void deallocate(void* ptr) noexcept {
+        uint32_t index = index_of(ptr);
+        if (index == npos)
+            return;
+
+        // Claim the block so a concurrent recover() or double free cannot push it twice
+        uint32_t owner = state(index).owner.load(std::memory_order_relaxed);
+        do {
+            if (owner == 0)
+                return;
+        } while (!state(index).owner.compare_exchange_weak(owner, 0, std::memory_order_relaxed));
+
+        push(index);
+    }
+
+    void deallocate(void* ptr, size_t /*size*/) noexcept {
+        deallocate(ptr);
+    }
+
+    /**
+     * @brief Hand ownership of a block to another process
+     *
+     * @param ptr Allocated block
+     * @param pid Running process (in the caller's pid namespace) that becomes
+     *            responsible for freeing it
+     * @return false, leaving the owner unchanged, if ptr is not a block, pid
+     *         is not running or the process table is full
+     */
+    bool transfer(void* ptr, int32_t pid) noexcept {
+        uint32_t index = index_of(ptr);
+        if (index == npos || pid <= 0)
+            return false;
+
+        platform::ProcessIdentity id = platform::process_identity(pid);
+        if (platform::process_state(id) != platform::ProcessState::Alive)
+            return false;
+
+        uint32_t word = register_process(id);
+        if (word == untracked)
+            return false;
+        state(index).owner.store(word, std::memory_order_relaxed);
+        return true;
+    }
+
+    /**
+     * @brief Get the process owning a block
+     *
+     * @return Its pid, 0 if the block is free, -1 if its owner is gone (the
+     *         block waits for recover()) or could not be tracked
+     */
+    int32_t owner(const void* ptr) const noexcept {
+        uint32_t index = index_of(ptr);
+        if (index == npos)
+            return 0;
+
+        uint32_t word = state(index).owner.load(std::memory_order_relaxed);
+        if (word == 0)
+            return 0;
+
+        const Process* p = process_of(word);
+        if (p == nullptr || !is_current(*p, word))
+            return -1;
+        return p->pid.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Free every block owned by a process that no longer exists
+     *
+     * Safe to call at any time from any attached process. See the class
+     * comment for the cases it cannot see.
+     *
+     * @return Number of blocks returned to the pool
+     */
+    size_t recover() noexcept {
+        if (mapping_.base == nullptr)
+            return 0;
+
+        // Retire table entries of processes that have exited (or whose pid was reused)
+        for (uint32_t e = 0; e < max_processes; ++e) {
+            Process& p = process(e);
+            uint32_t st = p.state.load(std::memory_order_acquire);
+            if ((st & 3) != entry_live)
+                continue;
+
+            platform::ProcessIdentity id;
+            id.pid = p.pid.load(std::memory_order_relaxed);
+            id.start_time = p.start_time.load(std::memory_order_relaxed);
+            id.pid_namespace = p.pid_namespace.load(std::memory_order_relaxed);
+            if (platform::process_state(id) == platform::ProcessState::Dead)
+                p.state.compare_exchange_strong(st, st & ~3u, std::memory_order_acq_rel);
+        }
+
+        // Then free every block whose owner word no longer names a live entry
+        size_t recovered = 0;
+        for (uint32_t i = 0; i < block_count(); ++i) {
+            uint32_t owner = state(i).owner.load(std::memory_order_relaxed);
+            if (owner == 0 || owner == untracked)
+                continue;
+
+            const Process* p = process_of(owner);
+            if (p == nullptr || is_current(*p, owner))
+                continue;
+
+            // Losing the race means someone else freed or recovered it
+            if (state(i).owner.compare_exchange_strong(owner, 0, std::memory_order_relaxed)) {
+                push(i);
+                ++recovered;
+            }
+        }
+        return recovered;
+    }
+
+    /**
+     * @brief Get the process-independent handle of a block
+     */
+    Handle handle(const void* ptr) const noexcept {
+        if (index_of(ptr) == npos)
+            return Handle{};
+        return Handle{static_cast<uint64_t>(static_cast<const char*>(ptr) - base())};
+    }
+
+    /**
+     * @brief Resolve a handle in this process's mapping
+     *
+     * @return The block, or nullptr for a null handle or one that is not a block
+     */
+    void* get(Handle handle) const noexcept {
+        if (!handle || handle.offset >= mapping_.size)
+            return nullptr;
+        char* p = base() + handle.offset;
+        return index_of(p) != npos ? p : nullptr;
+    }
+
+    template<typename T>
+    T* get(Handle handle) const noexcept {
+        return static_cast<T*>(get(handle));
+    }
+
+    /**
+     * @brief Get the usable bytes per block
+     */
+    size_t block_size() const noexcept {
+        return mapping_.base != nullptr ? static_cast<size_t>(header()->block_size) : 0;
+    }
+
+    /**
+     * @brief Get the number of blocks in the pool
+     */
+    uint32_t block_count() const noexcept {
+        return mapping_.base != nullptr ? header()->block_count : 0;
+    }
+
+    /**
+     * @brief Get the number of free blocks (a snapshot while others allocate)
+     */
+    uint32_t available() const noexcept {
+        return mapping_.base != nullptr ? header()->free_count.load(std::memory_order_relaxed) : 0;
+    }
+
+    /**
+     * @brief Get the descriptor of an anonymous pool (-1 for named pools)
+     */
+    int fd() const noexcept {
+        return mapping_.fd;
+    }
+
+    explicit operator bool() const noexcept {
+        return mapping_.base != nullptr;
+    }
+
+    /**
+     * @brief Check if ptr points into one of the pool's blocks
+     */
+    bool owns(const void* ptr) const noexcept {
+        if (mapping_.base == nullptr)
+            return false;
+        const char* p = static_cast<const char*>(ptr);
+        const char* first = base() + header()->blocks_offset;
+        return p >= first && p < first + header()->stride * header()->block_count;
+    }
+
+private:
+    static size_t stride_for(size_t block_size) noexcept {
+        return align_up(block_size, block_alignment);
+    }
+
+    static constexpr size_t states_offset = block_alignment + max_processes * sizeof(Process);
+
+    static size_t blocks_offset_for(size_t block_count) noexcept {
+        return align_up(states_offset + block_count * sizeof(BlockState), block_alignment);
+    }
+
+    // Total bytes for the pool, or 0 if the parameters are unusable
+    static size_t required_size(size_t block_size, size_t block_count) noexcept {
+        if (block_size == 0 || block_count == 0 || block_count >= npos || block_size > SIZE_MAX / 2)
+            return 0;
+
+        size_t stride = stride_for(block_size);
+        if (block_count > (SIZE_MAX / 2) / stride)
+            return 0;
+        return blocks_offset_for(block_count) + stride * block_count;
+    }
+
+    char* base() const noexcept {
+        return static_cast<char*>(mapping_.base);
+    }
+
+    Header* header() const noexcept {
+        return static_cast<Header*>(mapping_.base);
+    }
+
+    BlockState& state(uint32_t index) const noexcept {
+        return reinterpret_cast<BlockState*>(base() + states_offset)[index];
+    }
+
+    Process& process(uint32_t entry) const noexcept {
+        return reinterpret_cast<Process*>(base() + block_alignment)[entry];
+    }
+
+    // Table entry an owner word refers to, or nullptr for untracked words
+    const Process* process_of(uint32_t word) const noexcept {
+        uint32_t entry = (word & ((1u << entry_bits) - 1)) - 1;
+        return entry < max_processes ? &process(entry) : nullptr;
+    }
+
+    // Whether the entry is still live in the generation the word was issued for
+    static bool is_current(const Process& p, uint32_t word) noexcept {
+        uint32_t st = p.state.load(std::memory_order_acquire);
+        return (st & 3) == entry_live && ((st >> 2) & generation_mask) == word >> entry_bits;
+    }
+
+    static uint32_t word_for(uint32_t entry, uint32_t state) noexcept {
+        return (((state >> 2) & generation_mask) << entry_bits) | (entry + 1);
+    }
+
+    // Owner word of the calling process, registering it on first use (and after fork)
+    uint32_t self_word() noexcept {
+        int32_t pid = platform::current_process_id();
+        uint64_t self = self_.load(std::memory_order_relaxed);
+        if (static_cast<int32_t>(self >> 32) == pid && static_cast<uint32_t>(self) != 0)
+            return static_cast<uint32_t>(self);
+
+        // A full table is not remembered: entries retired by recover() may be claimed next time
+        uint32_t word = register_process(platform::current_process_identity());
+        if (word != untracked)
+            self_.store((static_cast<uint64_t>(static_cast<uint32_t>(pid)) << 32) | word, std::memory_order_relaxed);
+        return word;
+    }
+
+    // Find the live table entry of a process, or claim a free one for it
+    uint32_t register_process(const platform::ProcessIdentity& id) noexcept {
+        for (uint32_t e = 0; e < max_processes; ++e) {
+            Process& p = process(e);
+            uint32_t st = p.state.load(std::memory_order_acquire);
+            if ((st & 3) == entry_live &&
+                p.pid.load(std::memory_order_relaxed) == id.pid &&
+                p.start_time.load(std::memory_order_relaxed) == id.start_time &&
+                p.pid_namespace.load(std::memory_order_relaxed) == id.pid_namespace)
+                return word_for(e, st);
+        }
+
+        for (uint32_t e = 0; e < max_processes; ++e) {
+            Process& p = process(e);
+            uint32_t st = p.state.load(std::memory_order_relaxed);
+            if ((st & 3) != entry_free)
+                continue;
+
+            // A new generation per claim keeps the words of earlier occupants stale
+            uint32_t claimed = (st & ~3u) + 4;
+            if (!p.state.compare_exchange_strong(st, claimed | entry_claiming, std::memory_order_acquire))
+                continue;
+
+            p.pid.store(id.pid, std::memory_order_relaxed);
+            p.start_time.store(id.start_time, std::memory_order_relaxed);
+            p.pid_namespace.store(id.pid_namespace, std::memory_order_relaxed);
+            p.state.store(claimed | entry_live, std::memory_order_release);
+            return word_for(e, claimed);
+        }
+        return untracked;
+    }
+
+    char* block(uint32_t index) const noexcept {
+        return base() + header()->blocks_offset + header()->stride * index;
+    }
+
+    // Index of the block starting at ptr, or npos
+    uint32_t index_of(const void* ptr) const noexcept {
+        if (!owns(ptr))
+            return npos;
+
+        size_t offset = static_cast<size_t>(static_cast<const char*>(ptr) - base() - header()->blocks_offset);
+        if (offset % header()->stride != 0)
+            return npos;
+        return static_cast<uint32_t>(offset / header()->stride);
+    }
+
+    // Treiber stack over block indices; the tag in the upper half defeats ABA
+    uint32_t pop() noexcept {
+        Header* h = header();
+        uint64_t head = h->head.load(std::memory_order_acquire);
+        uint64_t desired;
+        uint32_t index;
+        do {
+            index = static_cast<uint32_t>(head);
+            if (index == npos)
+                return npos;
+            uint64_t next = state(index).next.load(std::memory_order_relaxed);
+            desired = ((head >> 32) + 1) << 32 | next;
+        } while (!h->head.compare_exchange_weak(head, desired,
+                                                std::memory_order_acquire, std::memory_order_acquire));
+
+        h->free_count.fetch_sub(1, std::memory_order_relaxed);
+        return index;
+    }
+
+    void push(uint32_t index) noexcept {
+        Header* h = header();
+        uint64_t head = h->head.load(std::memory_order_relaxed);
+        uint64_t desired;
+        do {
+            state(index).next.store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+            desired = ((head >> 32) + 1) << 32 | index;
+        } while (!h->head.compare_exchange_weak(head, desired,
+                                                std::memory_order_release, std::memory_order_relaxed));
+
+        h->free_count.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    static SharedPool init(platform::SharedMapping mapping, size_t block_size, size_t block_count) noexcept {
+        SharedPool pool;
+        pool.mapping_ = mapping;
+        if (mapping.base == nullptr)
+            return pool;
+
+        // Fresh shared memory is zero-filled: every owner is 0, every table entry free
+        Header* h = pool.header();
+        h->size = mapping.size;
+        h->block_size = block_size;
+        h->stride = stride_for(block_size);
+        h->blocks_offset = blocks_offset_for(block_count);
+        h->block_count = static_cast<uint32_t>(block_count);
+
+        for (uint32_t i = 0; i < h->block_count; ++i)
+            pool.state(i).next.store(i + 1 < h->block_count ? i + 1 : npos, std::memory_order_relaxed);
+        h->free_count.store(h->block_count, std::memory_order_relaxed);
+        h->head.store(0, std::memory_order_relaxed);
+
+        std::atomic_ref<uint64_t>(h->magic).store(Header::expected_magic, std::memory_order_release);
+        return pool;
+    }
+
+    static SharedPool attach(platform::SharedMapping mapping) noexcept {
+        SharedPool pool;
+        pool.mapping_ = mapping;
+        if (mapping.base == nullptr)
+            return pool;
+
+        const Header* h = pool.header();
+        if (mapping.size < block_alignment ||
+            std::atomic_ref<uint64_t>(pool.header()->magic).load(std::memory_order_acquire) != Header::expected_magic ||
+            h->size != mapping.size ||
+            h->blocks_offset + h->stride * h->block_count > mapping.size) {
+            platform::close_shared(pool.mapping_);
+        }
+        return pool;
+    }
+};
+
+} // namespace quanta
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+/**
+ * Statistics configuration, fixed at compile time. Define before including
+ * any ArenaX header, and identically in every translation unit:
+ *
+ *  QUANTA_ARENA_STATS  1 makes Arena and GrowingArena count their traffic (default 0)
+ *
+ * With statistics off the counters are empty members and every update
+ * compiles to nothing.
+ */
+#ifndef QUANTA_ARENA_STATS
+    #define QUANTA_ARENA_STATS 0
+#endif
+
+// MSVC accepts but ignores the standard attribute; it has its own spelling
+#if defined(_MSC_VER)
+    #define QUANTA_NO_UNIQUE_ADDRESS [[msvc::no_unique_address]]
+#else
+    #define QUANTA_NO_UNIQUE_ADDRESS [[no_unique_address]]
+#endif
+
+namespace quanta {
+
+/**
+ * @brief Snapshot of an arena's counters since construction
+ */
+struct ArenaStats {
+    size_t allocations = 0;         // successful allocations
+    size_t failures = 0;            // allocations that returned nullptr: out of space, or rejected
+                                    // (size 0, bad alignment, size overflow, frozen arena)
+    size_t bytes_requested = 0;     // sum of requested sizes
+    size_t bytes_consumed = 0;      // arena space taken, including alignment padding
+    size_t peak_used = 0;           // highest used() seen
+    size_t resets = 0;
+    size_t blocks = 0;              // memory blocks obtained (GrowingArena chains several)
+
+    /**
+     * @brief Get the bytes lost to alignment padding (and debug redzones)
+     */
+    size_t padding() const noexcept {
+        return bytes_consumed - bytes_requested;
+    }
+};
+
+namespace detail {
+
+// Counters written by the owning thread and readable from any other.
+// There is a single writer, so updates are plain loads and stores rather
+// than read-modify-write operations.
+class ArenaCounters {
+private:
+    std::atomic<size_t> allocations_{0};
+    std::atomic<size_t> failures_{0};
+    std::atomic<size_t> bytes_requested_{0};
+    std::atomic<size_t> bytes_consumed_{0};
+    std::atomic<size_t> peak_used_{0};
+    std::atomic<size_t> resets_{0};
+    std::atomic<size_t> blocks_{0};
+
+    static void add(std::atomic<size_t>& counter, size_t value) noexcept {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+public:
+    ArenaCounters() noexcept = default;
+
+    ArenaCounters(ArenaCounters&& other) noexcept {
+        assign(other.snapshot());
+        other.assign(ArenaStats());
+    }
+
+    ArenaCounters& operator=(ArenaCounters&& other) noexcept {
+        if (this != &other) {
+            assign(other.snapshot());
+            other.assign(ArenaStats());
+        }
+        return *this;
+    }
+
+    void on_allocate(size_t requested, size_t consumed, size_t used) noexcept {
+        add(allocations_, 1);
+        add(bytes_requested_, requested);
+        add(bytes_consumed_, consumed);
+        on_grow(used);
+    }
+
+    void on_resize(size_t requested, size_t consumed, size_t used) noexcept {
+        add(bytes_requested_, requested);
+        add(bytes_consumed_, consumed);
+        on_grow(used);
+    }
+
+    void on_failure() noexcept { add(failures_, 1); }
+    void on_reset() noexcept { add(resets_, 1); }
+    void on_block() noexcept { add(blocks_, 1); }
+
+    ArenaStats snapshot() const noexcept {
+        ArenaStats stats;
+        stats.allocations = allocations_.load(std::memory_order_relaxed);
+        stats.failures = failures_.load(std::memory_order_relaxed);
+        stats.bytes_requested = bytes_requested_.load(std::memory_order_relaxed);
+        stats.bytes_consumed = bytes_consumed_.load(std::memory_order_relaxed);
+        stats.peak_used = peak_used_.load(std::memory_order_relaxed);
+        stats.resets = resets_.load(std::memory_order_relaxed);
+        stats.blocks = blocks_.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+private:
+    void on_grow(size_t used) noexcept {
+        if (used > peak_used_.load(std::memory_order_relaxed))
+            peak_used_.store(used, std::memory_order_relaxed);
+    }
+
+    void assign(const ArenaStats& stats) noexcept {
+        allocations_.store(stats.allocations, std::memory_order_relaxed);
+        failures_.store(stats.failures, std::memory_order_relaxed);
+        bytes_requested_.store(stats.bytes_requested, std::memory_order_relaxed);
+        bytes_consumed_.store(stats.bytes_consumed, std::memory_order_relaxed);
+        peak_used_.store(stats.peak_used, std::memory_order_relaxed);
+        resets_.store(stats.resets, std::memory_order_relaxed);
+        blocks_.store(stats.blocks, std::memory_order_relaxed);
+    }
+};
+
+// Stand-in when statistics are compiled out
+struct NoArenaCounters {
+    void on_allocate(size_t, size_t, size_t) noexcept {}
+    void on_resize(size_t, size_t, size_t) noexcept {}
+    void on_failure() noexcept {}
+    void on_reset() noexcept {}
+    void on_block() noexcept {}
+    ArenaStats snapshot() const noexcept { return ArenaStats(); }
+};
+
+} // namespace detail
+
+inline constexpr bool stats_enabled = QUANTA_ARENA_STATS != 0;
+
+using ArenaCounters = std::conditional_t<stats_enabled, detail::ArenaCounters, detail::NoArenaCounters>;
+
+} // namespace quanta
@@ -0,0 +1,162 @@
+#pragma once
+
+#include "Arena.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string_view>
+#include <vector>
+
+namespace quanta {
+
+/**
+ * @brief Deduplicating string table whose bytes live in an Arena
+ *
+ * Every distinct string is copied into the arena once and identified by a
+ * dense 32-bit id, so equality between interned strings is an integer compare.
+ * Ids and views stay valid until the backing arena is reset; call clear()
+ * alongside arena.reset() to start a new interning cycle.
+ */
+class StringInterner {
+public:
+    using Id = uint32_t;
+
+    static constexpr Id invalid_id = UINT32_MAX;
+
+private:
+    struct Entry {
+        std::string_view str;
+        size_t hash;
+    };
+
+    Arena* arena_;
+    std::vector<Entry> entries_;    // indexed by id
+    std::vector<Id> slots_;         // open addressing table, invalid_id marks an empty slot
+
+public:
+
+    /**
+     * @brief Construct an interner that stores its strings in the given arena
+     *
+     * @param arena Arena receiving the string bytes (must outlive the interner)
+     */
+    explicit StringInterner(Arena& arena) : arena_(&arena) {}
+
+    /**
+     * @brief Intern a string, copying it into the arena if not already present
+     *
+     * @param str String to intern
+     * @return Id of the interned string or invalid_id if the arena is out of memory
+     */
+    Id intern(std::string_view str) {
+        size_t hash = std::hash<std::string_view>{}(str);
+
+        size_t slot = find_slot(str, hash);
+        if (!slots_.empty() && slots_[slot] != invalid_id)
+            return slots_[slot];
+
+        if (entries_.size() >= invalid_id) [[unlikely]]
+            return invalid_id;
+
+        // Copy the bytes first so a failed allocation leaves the table untouched
+        std::string_view stored;
+        if (!str.empty()) {
+            char* bytes = arena_->allocate<char>(str.size());
+            if (bytes == nullptr) [[unlikely]]
+                return invalid_id;
+            std::memcpy(bytes, str.data(), str.size());
+            stored = std::string_view(bytes, str.size());
+        }
+
+        if ((entries_.size() + 1) * 4 > slots_.size() * 3) {
+            rehash(slots_.empty() ? 16 : slots_.size() * 2);
+            slot = find_slot(str, hash);
+        }
+
+        Id id = static_cast<Id>(entries_.size());
+        entries_.push_back({stored, hash});
+        slots_[slot] = id;
+        return id;
+    }
+
+    /**
+     * @brief Look up a string without interning it
+     *
+     * @param str String to look up
+     * @return Id of the string or invalid_id if it was never interned
+     */
+    Id find(std::string_view str) const noexcept {
+        if (slots_.empty())
+            return invalid_id;
+        return slots_[find_slot(str, std::hash<std::string_view>{}(str))];
+    }
+
+    /**
+     * @brief Get the arena-owned view for an id
+     *
+     * @param id Id returned by intern()
+     * @return View of the interned bytes (empty for invalid ids)
+     */
+    std::string_view view(Id id) const noexcept {
+        if (id >= entries_.size())
+            return {};
+        return entries_[id].str;
+    }
+
+    /**
+     * @brief Intern a string and return its arena-owned view
+     *
+     * @param str String to intern
+     * @return Stable view of the interned bytes or an empty view on failure
+     */
+    std::string_view intern_view(std::string_view str) {
+        return view(intern(str));
+    }
+
+    /**
+     * @brief Forget all interned strings (the arena is not touched)
+     */
+    void clear() noexcept {
+        entries_.clear();
+        slots_.clear();
+    }
+
+    /**
+     * @brief Get the number of distinct strings interned
+     */
+    size_t size() const noexcept {
+        return entries_.size();
+    }
+
+private:
+    // Linear probe for str; returns the slot holding it or the empty slot where it belongs
+    size_t find_slot(std::string_view str, size_t hash) const noexcept {
+        if (slots_.empty())
+            return 0;
+
+        size_t mask = slots_.size() - 1;
+        size_t slot = hash & mask;
+        while (slots_[slot] != invalid_id) {
+            const Entry& entry = entries_[slots_[slot]];
+            if (entry.hash == hash && entry.str == str)
+                break;
+            slot = (slot + 1) & mask;
+        }
+        return slot;
+    }
+
+    void rehash(size_t slot_count) {
+        slots_.assign(slot_count, invalid_id);
+
+        size_t mask = slot_count - 1;
+        for (Id id = 0; id < entries_.size(); ++id) {
+            size_t slot = entries_[id].hash & mask;
+            while (slots_[slot] != invalid_id)
+                slot = (slot + 1) & mask;
+            slots_[slot] = id;
+        }
+    }
+};
+
+} // namespace quanta
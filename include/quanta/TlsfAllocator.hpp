@@ -0,0 +1,492 @@
+#pragma once
+
+#include "Arena.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace quanta {
+
+/**
+ * @brief Two-level segregated fit allocator with O(1) malloc and free
+ *
+ * Free blocks are binned by a first level (power of two) and a second level
+ * (32 linear subdivisions of it). Two levels of bitmaps locate a suitable
+ * non-empty bin with a couple of bit scans, and freed blocks are merged with
+ * their physical neighbours immediately, so both operations run in bounded
+ * time regardless of heap state. Suited to latency-critical paths.
+ *
+ * Every block carries a one-word header; the previous block's address is
+ * stored in the last word of a free block so neighbours can be reached
+ * without searching.
+ */
+class TlsfAllocator {
+private:
+    static constexpr unsigned sl_index_count_log2 = 5;
+    static constexpr unsigned align_size_log2 = 3;
+    static constexpr size_t align_size = size_t{1} << align_size_log2;
+    static constexpr unsigned fl_index_max = 40;
+    static constexpr unsigned sl_index_count = 1u << sl_index_count_log2;
+    static constexpr unsigned fl_index_shift = sl_index_count_log2 + align_size_log2;
+    static constexpr unsigned fl_index_count = fl_index_max - fl_index_shift + 1;
+    static constexpr size_t small_block_size = size_t{1} << fl_index_shift;
+
+    static constexpr size_t block_free_bit = 1;
+    static constexpr size_t block_prev_free_bit = 2;
+
+    struct Block {
+        Block* prev_phys;       // only valid while the previous block is free
+        size_t size;            // payload size | status bits
+        Block* next_free;       // only valid while this block is free
+        Block* prev_free;
+    };
+
+    // The size word is the only per-block overhead of a used block
+    static constexpr size_t block_header_overhead = sizeof(size_t);
+    static constexpr size_t block_start_offset = offsetof(Block, size) + sizeof(size_t);
+    static constexpr size_t block_size_min = sizeof(Block) - sizeof(Block*);
+    static constexpr size_t block_size_max = size_t{1} << fl_index_max;
+
+    char* region_;
+    size_t region_size_;
+    size_t used_;
+    uint64_t fl_bitmap_;
+    std::array<uint32_t, fl_index_count> sl_bitmap_;
+    std::array<std::array<Block*, sl_index_count>, fl_index_count> blocks_;
+
+public:
+    /**
+     * @brief Per-allocation bookkeeping cost in bytes
+     */
+    static constexpr size_t overhead = block_header_overhead;
+
+    /**
+     * @brief Construct an empty allocator that cannot allocate
+     */
+    TlsfAllocator() noexcept
+        : region_(nullptr), region_size_(0), used_(0), fl_bitmap_(0), sl_bitmap_{}, blocks_{} {}
+
+    /**
+     * @brief Manage a caller-provided region
+     *
+     * @param region Start of the memory to manage (must outlive the allocator)
+     * @param size Size of the region in bytes
+     */
+    TlsfAllocator(void* region, size_t size) noexcept
+        : TlsfAllocator()
+    {
+        add_region(region, size);
+    }
+
+    /**
+     * @brief Manage a region taken from an arena
+     *
+     * If the arena cannot provide it the allocator is left empty.
+     *
+     * @param arena Arena supplying the memory
+     * @param size Size of the region in bytes
+     */
+    TlsfAllocator(Arena& arena, size_t size) noexcept
+        : TlsfAllocator()
+    {
+        if (void* region = arena.allocate(size, align_size))
+            add_region(region, size);
+    }
+
+    // Free lists point into the region and the bins point at each other, so no copies
+    TlsfAllocator(const TlsfAllocator&) = delete;
+    TlsfAllocator& operator=(const TlsfAllocator&) = delete;
+
+    /**
+     * @brief Allocate memory with the given size and alignment
+     *
+     * @param size Number of bytes to allocate
+     * @param alignment Alignment requirement (must be power of 2)
+     * @return Pointer to allocated memory or nullptr if no free block fits
+     */
+    void* allocate(size_t size, size_t alignment = align_size) noexcept {
+        if (!is_power_of_2(alignment))
+            return nullptr;
+
+        size_t adjusted = adjust_request_size(size, align_size);
+        if (adjusted == 0)
+            return nullptr;
+
+        if (alignment <= align_size) {
+            Block* block = locate_free_block(adjusted);
+            return prepare_used(block, adjusted);
+        }
+
+        // Over-allocate so a free block can be split off in front of the aligned start
+        constexpr size_t gap_minimum = sizeof(Block);
+        if (alignment >= block_size_max || adjusted > block_size_max - alignment - gap_minimum)
+            return nullptr;
+
+        size_t with_gap = adjust_request_size(adjusted + alignment + gap_minimum, alignment);
+        Block* block = locate_free_block(with_gap);
+        if (block == nullptr)
+            return nullptr;
+
+        uintptr_t ptr = reinterpret_cast<uintptr_t>(to_ptr(block));
+        uintptr_t aligned = align_up(ptr, alignment);
+        size_t gap = aligned - ptr;
+
+        // A leading gap too small to hold a free block moves to the next aligned address
+        if (gap != 0 && gap < gap_minimum) {
+            size_t offset = std::max(gap_minimum - gap, alignment);
+            aligned = align_up(aligned + offset, alignment);
+            gap = aligned - ptr;
+        }
+
+        if (gap != 0)
+            block = trim_free_leading(block, gap);
+
+        return prepare_used(block, adjusted);
+    }
+
+    /**
+     * @brief Type-safe allocation for objects of type T
+     */
+    template<typename T>
+    T* allocate(size_t count = 1) noexcept {
+        if (count > SIZE_MAX / sizeof(T))
+            return nullptr;
+
+        return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    /**
+     * @brief Free memory and merge it with free physical neighbours
+     *
+     * @param ptr Pointer returned by allocate() (nullptr is ignored)
+     */
+    void deallocate(void* ptr) noexcept {
+        if (ptr == nullptr)
+            return;
+
+        Block* block = from_ptr(ptr);
+        used_ -= block_size(block);
+
+        mark_as_free(block);
+        block = merge_prev(block);
+        block = merge_next(block);
+        insert_block(block);
+    }
+
+    /**
+     * @brief Sized deallocation for composition; the size is not needed
+     */
+    void deallocate(void* ptr, size_t /*size*/) noexcept {
+        deallocate(ptr);
+    }
+
+    /**
+     * @brief Get the usable size of an allocation (at least the requested size)
+     */
+    static size_t usable_size(void* ptr) noexcept {
+        return ptr != nullptr ? block_size(from_ptr(ptr)) : 0;
+    }
+
+    /**
+     * @brief Get the number of bytes in used blocks (excluding headers)
+     */
+    size_t used() const noexcept {
+        return used_;
+    }
+
+    /**
+     * @brief Get the size of the managed region
+     */
+    size_t capacity() const noexcept {
+        return region_size_;
+    }
+
+    /**
+     * @brief Check if ptr belongs to the managed region
+     *
+     * @param ptr Pointer to check
+     */
+    bool owns(void* ptr) const noexcept {
+        return ptr >= region_ && ptr < region_ + region_size_;
+    }
+
+private:
+    // BIT HELPERS
+
+    static unsigned fls(size_t x) noexcept {
+        return static_cast<unsigned>(63 - std::countl_zero(static_cast<uint64_t>(x)));
+    }
+
+    static unsigned ffs(uint64_t x) noexcept {
+        return static_cast<unsigned>(std::countr_zero(x));
+    }
+
+    // BLOCK ACCESS
+
+    static size_t block_size(const Block* block) noexcept {
+        return block->size & ~(block_free_bit | block_prev_free_bit);
+    }
+
+    static void set_size(Block* block, size_t size) noexcept {
+        block->size = size | (block->size & (block_free_bit | block_prev_free_bit));
+    }
+
+    static bool is_free(const Block* block) noexcept {
+        return (block->size & block_free_bit) != 0;
+    }
+
+    static bool is_prev_free(const Block* block) noexcept {
+        return (block->size & block_prev_free_bit) != 0;
+    }
+
+    static void set_free(Block* block, bool free) noexcept {
+        block->size = free ? (block->size | block_free_bit) : (block->size & ~block_free_bit);
+    }
+
+    static void set_prev_free(Block* block, bool free) noexcept {
+        block->size = free ? (block->size | block_prev_free_bit) : (block->size & ~block_prev_free_bit);
+    }
+
+    static void* to_ptr(Block* block) noexcept {
+        return reinterpret_cast<char*>(block) + block_start_offset;
+    }
+
+    static Block* from_ptr(void* ptr) noexcept {
+        return reinterpret_cast<Block*>(static_cast<char*>(ptr) - block_start_offset);
+    }
+
+    // The next block's header overlaps the last word of this block's payload
+    static Block* next_block(Block* block) noexcept {
+        return reinterpret_cast<Block*>(static_cast<char*>(to_ptr(block)) + block_size(block) - block_header_overhead);
+    }
+
+    static Block* link_next(Block* block) noexcept {
+        Block* next = next_block(block);
+        next->prev_phys = block;
+        return next;
+    }
+
+    static void mark_as_free(Block* block) noexcept {
+        Block* next = link_next(block);
+        set_prev_free(next, true);
+        set_free(block, true);
+    }
+
+    static void mark_as_used(Block* block) noexcept {
+        Block* next = next_block(block);
+        set_prev_free(next, false);
+        set_free(block, false);
+    }
+
+    static size_t adjust_request_size(size_t size, size_t alignment) noexcept {
+        if (size == 0 || size > block_size_max)
+            return 0;
+
+        size_t aligned = align_up(size, alignment);
+        if (aligned >= block_size_max)
+            return 0;
+        return std::max(aligned, block_size_min);
+    }
+
+    // BIN MAPPING
+
+    static void mapping_insert(size_t size, unsigned& fl, unsigned& sl) noexcept {
+        if (size < small_block_size) {
+            fl = 0;
+            sl = static_cast<unsigned>(size / (small_block_size / sl_index_count));
+        } else {
+            unsigned bit = fls(size);
+            sl = static_cast<unsigned>(size >> (bit - sl_index_count_log2)) ^ sl_index_count;
+            fl = bit - (fl_index_shift - 1);
+        }
+    }
+
+    // Round up to the next bin so any block found there is large enough
+    static void mapping_search(size_t size, unsigned& fl, unsigned& sl) noexcept {
+        if (size >= small_block_size)
+            size += (size_t{1} << (fls(size) - sl_index_count_log2)) - 1;
+        mapping_insert(size, fl, sl);
+    }
+
+    Block* search_suitable_block(unsigned& fl, unsigned& sl) const noexcept {
+        uint32_t sl_map = sl_bitmap_[fl] & (~uint32_t{0} << sl);
+        if (sl_map == 0) {
+            if (fl + 1 >= fl_index_count)
+                return nullptr;
+            uint64_t fl_map = fl_bitmap_ & (~uint64_t{0} << (fl + 1));
+            if (fl_map == 0)
+                return nullptr;
+
+            fl = ffs(fl_map);
+            sl_map = sl_bitmap_[fl];
+        }
+        sl = ffs(sl_map);
+        return blocks_[fl][sl];
+    }
+
+    // FREE LISTS
+
+    void remove_free_block(Block* block, unsigned fl, unsigned sl) noexcept {
+        Block* prev = block->prev_free;
+        Block* next = block->next_free;
+        if (next != nullptr)
+            next->prev_free = prev;
+        if (prev != nullptr)
+            prev->next_free = next;
+
+        if (blocks_[fl][sl] == block) {
+            blocks_[fl][sl] = next;
+            if (next == nullptr) {
+                sl_bitmap_[fl] &= ~(uint32_t{1} << sl);
+                if (sl_bitmap_[fl] == 0)
+                    fl_bitmap_ &= ~(uint64_t{1} << fl);
+            }
+        }
+    }
+
+    void insert_free_block(Block* block, unsigned fl, unsigned sl) noexcept {
+        Block* current = blocks_[fl][sl];
+        block->next_free = current;
+        block->prev_free = nullptr;
+        if (current != nullptr)
+            current->prev_free = block;
+
+        blocks_[fl][sl] = block;
+        fl_bitmap_ |= uint64_t{1} << fl;
+        sl_bitmap_[fl] |= uint32_t{1} << sl;
+    }
+
+    void remove_block(Block* block) noexcept {
+        unsigned fl, sl;
+        mapping_insert(block_size(block), fl, sl);
+        remove_free_block(block, fl, sl);
+    }
+
+    void insert_block(Block* block) noexcept {
+        unsigned fl, sl;
+        mapping_insert(block_size(block), fl, sl);
+        insert_free_block(block, fl, sl);
+    }
+
+    // SPLIT AND MERGE
+
+    static bool can_split(const Block* block, size_t size) noexcept {
+        return block_size(block) >= sizeof(Block) + size;
+    }
+
+    static Block* split(Block* block, size_t size) noexcept {
+        Block* remaining = reinterpret_cast<Block*>(static_cast<char*>(to_ptr(block)) + size - block_header_overhead);
+        size_t remaining_size = block_size(block) - (size + block_header_overhead);
+
+        remaining->size = 0;
+        set_size(remaining, remaining_size);
+        set_size(block, size);
+        mark_as_free(remaining);
+        return remaining;
+    }
+
+    static Block* absorb(Block* prev, Block* block) noexcept {
+        set_size(prev, block_size(prev) + block_size(block) + block_header_overhead);
+        link_next(prev);
+        return prev;
+    }
+
+    Block* merge_prev(Block* block) noexcept {
+        if (is_prev_free(block)) {
+            Block* prev = block->prev_phys;
+            remove_block(prev);
+            block = absorb(prev, block);
+        }
+        return block;
+    }
+
+    Block* merge_next(Block* block) noexcept {
+        Block* next = next_block(block);
+        if (is_free(next)) {
+            remove_block(next);
+            block = absorb(block, next);
+        }
+        return block;
+    }
+
+    void trim_free(Block* block, size_t size) noexcept {
+        if (can_split(block, size)) {
+            Block* remaining = split(block, size);
+            link_next(block);
+            set_prev_free(remaining, true);
+            insert_block(remaining);
+        }
+    }
+
+    Block* trim_free_leading(Block* block, size_t size) noexcept {
+        Block* remaining = block;
+        if (can_split(block, size)) {
+            remaining = split(block, size - block_header_overhead);
+            set_prev_free(remaining, true);
+            link_next(block);
+            insert_block(block);
+        }
+        return remaining;
+    }
+
+    Block* locate_free_block(size_t size) noexcept {
+        unsigned fl, sl;
+        mapping_search(size, fl, sl);
+        if (fl >= fl_index_count)
+            return nullptr;
+
+        Block* block = search_suitable_block(fl, sl);
+        if (block != nullptr)
+            remove_free_block(block, fl, sl);
+        return block;
+    }
+
+    void* prepare_used(Block* block, size_t size) noexcept {
+        if (block == nullptr)
+            return nullptr;
+
+        trim_free(block, size);
+        mark_as_used(block);
+        used_ += block_size(block);
+        return to_ptr(block);
+    }
+
+    // REGION SETUP
+
+    void add_region(void* region, size_t size) noexcept {
+        uintptr_t start = reinterpret_cast<uintptr_t>(region);
+        uintptr_t aligned = align_up(start, align_size);
+        if (aligned - start > size)
+            return;
+        size -= aligned - start;
+
+        // First block's prev_phys word, its size word and the end sentinel's size word
+        constexpr size_t region_overhead = sizeof(Block*) + 2 * block_header_overhead;
+        if (size < region_overhead + block_size_min)
+            return;
+
+        size_t payload = (size - region_overhead) & ~(align_size - 1);
+        payload = std::min(payload, (block_size_max - 1) & ~(align_size - 1));
+
+        Block* block = reinterpret_cast<Block*>(aligned);
+        block->size = 0;
+        set_size(block, payload);
+        set_free(block, true);
+        set_prev_free(block, false);
+        insert_block(block);
+
+        // Zero-sized used sentinel stops merges at the end of the region
+        Block* sentinel = link_next(block);
+        sentinel->size = 0;
+        set_free(sentinel, false);
+        set_prev_free(sentinel, true);
+
+        region_ = reinterpret_cast<char*>(aligned);
+        region_size_ = payload + region_overhead;
+    }
+};
+
+} // namespace quanta
@@ -0,0 +1,480 @@
+#pragma once
+
+#include "Common.hpp"
+#include "Composable.hpp"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace quanta {
+
+/**
+ * @brief One traced allocator operation, 32 bytes on disk
+ */
+struct TraceRecord {
+    enum class Op : uint8_t {
+        Allocate,
+        Deallocate,
+        Reset,
+    };
+
+    uint64_t timestamp;         // nanoseconds since the tracer was created
+    uint64_t address;           // identifies the allocation; 0 for failures and resets
+    uint64_t size;
+    uint32_t thread;            // small per-tracer thread number, starting at 0
+    Op op;
+    uint8_t alignment_log2;
+    uint16_t reserved;
+
+    size_t alignment() const noexcept {
+        return size_t{1} << alignment_log2;
+    }
+};
+
+static_assert(sizeof(TraceRecord) == 32);
+
+/**
+ * @brief File header written once at the start of a trace
+ */
+struct TraceFileHeader {
+    static constexpr char expected_magic[8] = {'Q', 'T', 'R', 'A', 'C', 'E', '0', '1'};
+
+    char magic[8];
+    uint32_t record_size;
+    uint32_t reserved;
+};
+
+/**
+ * @brief Records allocator operations into per-thread buffers flushed to a file
+ *
+ * record() only appends to the calling thread's buffer for this tracer; the
+ * file lock is taken once per full buffer. Records from different threads
+ * are therefore written in chunks; read_trace() puts them back in timestamp
+ * order. A thread recording into several tracers keeps a buffer (and a
+ * thread number) per tracer, so switching between them costs nothing.
+ *
+ * Records that cannot be buffered or written (out of memory, write errors)
+ * are counted in dropped() rather than failing the traced allocation.
+ *
+ * Buffers are flushed when full, on flush() (calling thread), when their
+ * thread exits and when the tracer is destroyed. Destroy the tracer only
+ * once the traced threads have stopped recording.
+ */
+class Tracer {
+private:
+    struct ThreadBuffer;
+
+    std::FILE* file_;
+    std::chrono::steady_clock::time_point start_;
+    size_t buffer_records_;
+    std::mutex file_mutex_;
+    std::vector<ThreadBuffer*> buffers_;        // guarded by registry_mutex()
+    std::atomic<uint32_t> next_thread_;
+    std::atomic<uint64_t> dropped_;
+
+    struct ThreadBuffer {
+        std::atomic<Tracer*> owner{nullptr};    // nullptr once the tracer is gone; set under registry_mutex()
+        uint32_t thread = 0;
+        std::vector<TraceRecord> records;
+    };
+
+    // The calling thread's buffers, one per tracer it has recorded into
+    struct ThreadBuffers {
+        std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+        ThreadBuffer* last = nullptr;       // buffer of the most recent record()
+
+        ~ThreadBuffers() {
+            std::lock_guard<std::mutex> lock(registry_mutex());
+            for (auto& buffer : buffers) {
+                if (Tracer* owner = buffer->owner.load(std::memory_order_relaxed)) {
+                    owner->write(buffer->records);
+                    owner->unregister(buffer.get());
+                }
+            }
+        }
+    };
+
+    // Guards the link between tracers and thread buffers, which die in either order
+    static std::mutex& registry_mutex() noexcept {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    static ThreadBuffers& local_buffers() noexcept {
+        thread_local ThreadBuffers buffers;
+        return buffers;
+    }
+
+public:
+
+    /**
+     * @brief Start a trace file
+     *
+     * @param path File to create or overwrite
+     * @param buffer_records Records buffered per thread before writing
+     */
+    explicit Tracer(const char* path, size_t buffer_records = 4096) noexcept
+        : file_(std::fopen(path, "wb")),
+          start_(std::chrono::steady_clock::now()),
+          buffer_records_(std::max<size_t>(buffer_records, 1)),
+          next_thread_(0),
+          dropped_(0)
+    {
+        if (file_ == nullptr)
+            return;
+
+        TraceFileHeader header{};
+        std::memcpy(header.magic, TraceFileHeader::expected_magic, sizeof(header.magic));
+        header.record_size = sizeof(TraceRecord);
+        if (std::fwrite(&header, sizeof(header), 1, file_) != 1) {
+            std::fclose(file_);
+            file_ = nullptr;
+        }
+    }
+
+    /**
+     * @brief Flush every thread's buffer and close the file
+     */
+    ~Tracer() {
+        {
+            std::lock_guard<std::mutex> lock(registry_mutex());
+            for (ThreadBuffer* buffer : buffers_) {
+                write(buffer->records);
+                buffer->owner.store(nullptr, std::memory_order_relaxed);
+            }
+            buffers_.clear();
+        }
+
+        if (file_ != nullptr)
+            std::fclose(file_);
+    }
+
+    Tracer(const Tracer&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+
+    /**
+     * @brief Check whether the trace file could be opened
+     */
+    explicit operator bool() const noexcept {
+        return file_ != nullptr;
+    }
+
+    /**
+     * @brief Append a record to the calling thread's buffer
+     *
+     * @param op Operation
+     * @param ptr Allocation the operation refers to (nullptr for failures and resets)
+     * @param size Requested size
+     * @param alignment Requested alignment (power of 2)
+     */
+    void record(TraceRecord::Op op, const void* ptr, size_t size, size_t alignment = 1) noexcept {
+        if (file_ == nullptr)
+            return;
+
+        ThreadBuffers& local = local_buffers();
+        ThreadBuffer* buffer = local.last;
+        if (buffer == nullptr || buffer->owner.load(std::memory_order_relaxed) != this) [[unlikely]] {
+            buffer = find_or_attach(local);
+            if (buffer == nullptr) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            local.last = buffer;
+        }
+
+        TraceRecord r{};
+        r.timestamp = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start_).count());
+        r.address = reinterpret_cast<uintptr_t>(ptr);
+        r.size = size;
+        r.thread = buffer->thread;
+        r.op = op;
+        r.alignment_log2 = static_cast<uint8_t>(std::countr_zero(std::max<size_t>(alignment, 1)));
+
+        // Capacity is reserved on attach, so this only allocates if that failed
+        try {
+            buffer->records.push_back(r);
+        } catch (const std::bad_alloc&) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        if (buffer->records.size() >= buffer_records_)
+            write(buffer->records);
+    }
+
+    /**
+     * @brief Write the calling thread's buffered records
+     */
+    void flush() noexcept {
+        for (auto& buffer : local_buffers().buffers) {
+            if (buffer->owner.load(std::memory_order_relaxed) == this)
+                write(buffer->records);
+        }
+
+        std::lock_guard<std::mutex> lock(file_mutex_);
+        if (file_ != nullptr)
+            std::fflush(file_);
+    }
+
+    /**
+     * @brief Get the number of records lost to allocation failures or write errors
+     */
+    uint64_t dropped() const noexcept {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+private:
+    // The calling thread's buffer for this tracer, created on first use; nullptr when out of memory
+    ThreadBuffer* find_or_attach(ThreadBuffers& local) noexcept {
+        std::lock_guard<std::mutex> lock(registry_mutex());
+
+        ThreadBuffer* spare = nullptr;
+        for (auto& buffer : local.buffers) {
+            Tracer* owner = buffer->owner.load(std::memory_order_relaxed);
+            if (owner == this)
+                return buffer.get();
+            if (owner == nullptr && spare == nullptr)
+                spare = buffer.get();     // left behind by a destroyed tracer
+        }
+
+        try {
+            if (spare == nullptr) {
+                local.buffers.push_back(std::make_unique<ThreadBuffer>());
+                spare = local.buffers.back().get();
+            }
+            spare->records.clear();
+            spare->records.reserve(buffer_records_);
+            buffers_.push_back(spare);
+        } catch (const std::bad_alloc&) {
+            return nullptr;
+        }
+
+        spare->owner.store(this, std::memory_order_relaxed);
+        spare->thread = next_thread_.fetch_add(1, std::memory_order_relaxed);
+        return spare;
+    }
+
+    void unregister(ThreadBuffer* buffer) noexcept {
+        buffers_.erase(std::remove(buffers_.begin(), buffers_.end(), buffer), buffers_.end());
+    }
+
+    void write(std::vector<TraceRecord>& records) noexcept {
+        if (records.empty())
+            return;
+
+        std::lock_guard<std::mutex> lock(file_mutex_);
+        size_t written = file_ != nullptr ? std::fwrite(records.data(), sizeof(TraceRecord), records.size(), file_) : 0;
+        if (written < records.size())
+            dropped_.fetch_add(records.size() - written, std::memory_order_relaxed);
+        records.clear();
+    }
+};
+
+/**
+ * @brief Read a trace file back, sorted by timestamp
+ *
+ * @param path File written by a Tracer
+ * @param out Receives the records
+ * @return false if the file is missing or not a trace
+ */
+inline bool read_trace(const char* path, std::vector<TraceRecord>& out) {
+    std::FILE* file = std::fopen(path, "rb");
+    if (file == nullptr)
+        return false;
+
+    TraceFileHeader header{};
+    if (std::fread(&header, sizeof(header), 1, file) != 1 ||
+        std::memcmp(header.magic, TraceFileHeader::expected_magic, sizeof(header.magic)) != 0 ||
+        header.record_size != sizeof(TraceRecord)) {
+        std::fclose(file);
+        return false;
+    }
+
+    out.clear();
+    TraceRecord chunk[1024];
+    size_t n;
+    while ((n = std::fread(chunk, sizeof(TraceRecord), std::size(chunk), file)) > 0)
+        out.insert(out.end(), chunk, chunk + n);
+    std::fclose(file);
+
+    std::stable_sort(out.begin(), out.end(), [](const TraceRecord& a, const TraceRecord& b) {
+        return a.timestamp < b.timestamp;
+    });
+    return true;
+}
+
+/**
+ * @brief Records every operation going through an allocator
+ *
+ * Slots into a composition like any other building block. reset() is
+ * forwarded (and traced) when the parent has one, e.g. an Arena.
+ */
+template<Allocator A>
+class TracingAllocator {
+private:
+    A parent_;
+    Tracer* tracer_;
+
+public:
+    TracingAllocator(A parent, Tracer& tracer) noexcept
+        : parent_(std::move(parent)), tracer_(&tracer) {}
+
+    void* allocate(size_t size, size_t alignment) noexcept {
+        void* p = parent_.allocate(size, alignment);
+        tracer_->record(TraceRecord::Op::Allocate, p, size, alignment);
+        return p;
+    }
+
+    void deallocate(void* ptr, size_t size) noexcept {
+        if (ptr == nullptr)
+            return;
+        tracer_->record(TraceRecord::Op::Deallocate, ptr, size);
+        parent_.deallocate(ptr, size);
+    }
+
+    void reset() noexcept requires requires(A& a) { a.reset(); } {
+        tracer_->record(TraceRecord::Op::Reset, nullptr, 0);
+        parent_.reset();
+    }
+
+    bool owns(void* ptr) const noexcept requires OwningAllocator<A> {
+        return parent_.owns(ptr);
+    }
+
+    A& parent() noexcept { return parent_; }
+};
+
+/**
+ * @brief Outcome of replaying a trace
+ */
+struct ReplayResult {
+    size_t allocations = 0;         // successful allocations
+    size_t failures = 0;            // allocations the replayed allocator refused
+    size_t deallocations = 0;       // including frees issued for resets and reused addresses
+    size_t resets = 0;
+    size_t skipped = 0;             // frees of unknown addresses
+    size_t peak_live_bytes = 0;
+    std::chrono::nanoseconds elapsed{0};   // inside allocate, deallocate and reset
+
+    /**
+     * @brief Get the number of timed operations, i.e. the divisor for elapsed
+     */
+    size_t operations() const noexcept {
+        return allocations + failures + deallocations + resets;
+    }
+};
+
+/**
+ * @brief Drive an allocator with a recorded trace
+ *
+ * Operations are issued from the calling thread in timestamp order.
+ * Allocations that failed when traced are replayed as well, so a more
+ * capable allocator can succeed where the original did not. Every byte
+ * handed out is written once, as a real program would.
+ *
+ * A traced reset is replayed with reset() where the allocator has one;
+ * otherwise every live allocation is freed (and timed) one by one. An
+ * allocation traced at an address that is still live (its free was not
+ * traced) frees the older replayed block first, so nothing leaks.
+ *
+ * @param records Trace as returned by read_trace()
+ * @param allocator Allocator under test
+ * @param touch Whether to write to each allocation
+ * @return Counts and the time spent inside the allocator
+ */
+template<Allocator A>
+ReplayResult replay(const std::vector<TraceRecord>& records, A& allocator, bool touch = true) {
+    struct Live {
+        void* ptr;
+        size_t size;
+    };
+
+    ReplayResult result;
+    std::unordered_map<uint64_t, Live> live;
+    live.reserve(records.size() / 2 + 1);
+    size_t live_bytes = 0;
+    std::chrono::steady_clock::duration elapsed{0};
+
+    for (const TraceRecord& r : records) {
+        switch (r.op) {
+        case TraceRecord::Op::Allocate: {
+            auto start = std::chrono::steady_clock::now();
+            void* p = allocator.allocate(static_cast<size_t>(r.size), r.alignment());
+            elapsed += std::chrono::steady_clock::now() - start;
+
+            if (p == nullptr) {
+                ++result.failures;
+                break;
+            }
+            if (touch)
+                std::memset(p, 0, static_cast<size_t>(r.size));
+
+            ++result.allocations;
+            // Untraced failures have address 0; key them off the record index instead
+            uint64_t key = r.address != 0 ? r.address : ~static_cast<uint64_t>(&r - records.data());
+            auto [it, inserted] = live.try_emplace(key, Live{p, static_cast<size_t>(r.size)});
+            if (!inserted) {
+                start = std::chrono::steady_clock::now();
+                allocator.deallocate(it->second.ptr, it->second.size);
+                elapsed += std::chrono::steady_clock::now() - start;
+
+                live_bytes -= it->second.size;
+                ++result.deallocations;
+                it->second = Live{p, static_cast<size_t>(r.size)};
+            }
+            live_bytes += static_cast<size_t>(r.size);
+            result.peak_live_bytes = std::max(result.peak_live_bytes, live_bytes);
+            break;
+        }
+        case TraceRecord::Op::Deallocate: {
+            auto it = live.find(r.address);
+            if (it == live.end()) {
+                ++result.skipped;
+                break;
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            allocator.deallocate(it->second.ptr, it->second.size);
+            elapsed += std::chrono::steady_clock::now() - start;
+
+            live_bytes -= it->second.size;
+            live.erase(it);
+            ++result.deallocations;
+            break;
+        }
+        case TraceRecord::Op::Reset: {
+            auto start = std::chrono::steady_clock::now();
+            if constexpr (requires { allocator.reset(); }) {
+                allocator.reset();
+            } else {
+                for (const auto& entry : live)
+                    allocator.deallocate(entry.second.ptr, entry.second.size);
+                result.deallocations += live.size();
+            }
+            elapsed += std::chrono::steady_clock::now() - start;
+
+            live.clear();
+            live_bytes = 0;
+            ++result.resets;
+            break;
+        }
+        }
+    }
+
+    result.elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed);
+    return result;
+}
+
+} // namespace quanta
@@ -1,6 +1,13 @@
 #include <gtest/gtest.h>
 #include "quanta/Arena.hpp"
 
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <type_traits>
+
 using namespace quanta;
 
 // CONSTRUCTION AND DESTRUCTION
@@ -125,6 +132,445 @@ TEST(ArenaTest, MultipleResetCycles) {
     }
 }
 
+// IN-PLACE RESIZE
+
+TEST(ArenaTest, ResizeLastAllocation) {
+    Arena arena(1024);
+
+    void* p = arena.allocate(100, 1);
+    ASSERT_NE(p, nullptr);
+
+    EXPECT_TRUE(arena.resize(p, 100, 300));
+    EXPECT_EQ(arena.used(), 300);
+
+    EXPECT_TRUE(arena.resize(p, 300, 50));
+    EXPECT_EQ(arena.used(), 50);
+}
+
+TEST(ArenaTest, ResizeRejectsOlderAllocation) {
+    Arena arena(1024);
+
+    void* p1 = arena.allocate(100, 1);
+    void* p2 = arena.allocate(100, 1);
+    ASSERT_NE(p2, nullptr);
+
+    EXPECT_FALSE(arena.resize(p1, 100, 150));
+    EXPECT_EQ(arena.used(), 200);
+}
+
+TEST(ArenaTest, ResizeBeyondCapacity) {
+    Arena arena(128);
+
+    void* p = arena.allocate(64, 1);
+    EXPECT_FALSE(arena.resize(p, 64, 129));
+    EXPECT_EQ(arena.used(), 64);
+    EXPECT_TRUE(arena.resize(p, 64, 128));
+    EXPECT_EQ(arena.available(), 0);
+}
+
+// SUB-ARENAS
+
+TEST(ArenaTest, SubArenaBorrowsSlice) {
+    Arena parent(1024);
+
+    Arena child = parent.sub_arena(256, 8);
+    EXPECT_TRUE(child.is_sub_arena());
+    EXPECT_EQ(child.capacity(), 256);
+    EXPECT_EQ(parent.used(), 256);
+
+    void* p = child.allocate(100, 8);
+    ASSERT_NE(p, nullptr);
+    EXPECT_TRUE(parent.owns(p));
+    EXPECT_EQ(child.used(), 100);
+    EXPECT_EQ(parent.used(), 256);
+}
+
+TEST(ArenaTest, SubArenaBudgetEnforced) {
+    Arena parent(1024);
+    Arena child = parent.sub_arena(128, 8);
+
+    EXPECT_NE(child.allocate(128, 1), nullptr);
+    EXPECT_EQ(child.allocate(1, 1), nullptr);
+    EXPECT_EQ(parent.used(), 128);
+}
+
+TEST(ArenaTest, SubArenaTooLarge) {
+    Arena parent(128);
+
+    Arena child = parent.sub_arena(256);
+    EXPECT_FALSE(child.is_sub_arena());
+    EXPECT_EQ(child.capacity(), 0);
+    EXPECT_EQ(child.allocate(1, 1), nullptr);
+    EXPECT_EQ(parent.used(), 0);
+}
+
+TEST(ArenaTest, SubArenaReturnsSliceWhenLast) {
+    Arena parent(1024);
+    parent.allocate(16, 1);
+    size_t before = parent.used();
+
+    {
+        Arena child = parent.sub_arena(512, 1);
+        EXPECT_EQ(parent.used(), before + 512);
+    }
+
+    EXPECT_EQ(parent.used(), before);
+}
+
+TEST(ArenaTest, SubArenaKeptWhenNotLast) {
+    Arena parent(1024);
+
+    {
+        Arena child = parent.sub_arena(256, 1);
+        parent.allocate(10, 1);
+    }
+
+    EXPECT_EQ(parent.used(), 266);
+}
+
+TEST(ArenaTest, SubArenaKeptAfterParentReset) {
+    Arena parent(1024);
+    void* p = nullptr;
+
+    {
+        Arena child = parent.sub_arena(256, 1);
+        parent.reset();
+
+        // Lands exactly where the slice was
+        p = parent.allocate(256, 1);
+        ASSERT_EQ(p, child.data());
+    }
+
+    // The unrelated allocation is still in use; nothing may overlap it
+    EXPECT_EQ(parent.used(), 256);
+    void* q = parent.allocate(16, 1);
+    ASSERT_NE(q, nullptr);
+    EXPECT_GE(static_cast<char*>(q), static_cast<char*>(p) + 256);
+}
+
+TEST(ArenaTest, NestedSubArenas) {
+    Arena parent(1024);
+
+    {
+        Arena child = parent.sub_arena(512, 1);
+        {
+            Arena grandchild = child.sub_arena(128, 1);
+            EXPECT_NE(grandchild.allocate(64, 1), nullptr);
+            EXPECT_EQ(child.used(), 128);
+        }
+        EXPECT_EQ(child.used(), 0);
+    }
+
+    EXPECT_EQ(parent.used(), 0);
+}
+
+TEST(ArenaTest, SubArenaMove) {
+    Arena parent(1024);
+
+    Arena outer;
+    {
+        Arena child = parent.sub_arena(256, 1);
+        outer = std::move(child);
+    }
+
+    // Slice is still held by the moved-to arena
+    EXPECT_EQ(parent.used(), 256);
+    EXPECT_TRUE(outer.is_sub_arena());
+
+    outer = Arena();
+    EXPECT_EQ(parent.used(), 0);
+}
+
+// FILE-BACKED ARENAS
+
+#if !defined(_WIN32)
+namespace {
+
+std::string write_temp_file(const std::string& contents) {
+    std::string path = testing::TempDir() + "arena_map_file_" + std::to_string(std::rand()) + ".bin";
+    std::ofstream(path, std::ios::binary) << contents;
+    return path;
+}
+
+std::string read_file(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), {});
+}
+
+} // namespace
+
+TEST(ArenaTest, MapFileReadOnly) {
+    std::string contents = "reference data";
+    std::string path = write_temp_file(contents);
+
+    Arena arena = Arena::map_file(path.c_str(), Arena::FileMode::ReadOnly, 1 << 20);
+    ASSERT_NE(arena.data(), nullptr);
+    EXPECT_EQ(std::memcmp(arena.data(), contents.data(), contents.size()), 0);
+    EXPECT_GE(arena.capacity(), size_t{1} << 20);
+
+    // Appends start on the page after the read-only file contents
+    char* p = static_cast<char*>(arena.allocate(64, 8));
+    ASSERT_NE(p, nullptr);
+    EXPECT_GE(p, arena.data() + contents.size());
+    std::memset(p, 'x', 64);
+
+    arena.reset();
+    EXPECT_EQ(arena.allocate(64, 8), p);
+    EXPECT_EQ(std::memcmp(arena.data(), contents.data(), contents.size()), 0);
+
+    std::remove(path.c_str());
+}
+
+TEST(ArenaTest, MapFileCopyOnWrite) {
+    std::string contents = "0123456789";
+    std::string path = write_temp_file(contents);
+
+    {
+        Arena arena = Arena::map_file(path.c_str(), Arena::FileMode::CopyOnWrite, 4096);
+        ASSERT_NE(arena.data(), nullptr);
+        EXPECT_EQ(arena.used(), contents.size());
+
+        // Allocation continues right after the file contents
+        char* p = static_cast<char*>(arena.allocate(1, 1));
+        EXPECT_EQ(p, arena.data() + contents.size());
+
+        arena.data()[0] = 'X';
+        EXPECT_EQ(arena.data()[0], 'X');
+    }
+
+    // Private mapping: the file itself is unchanged
+    EXPECT_EQ(read_file(path), contents);
+    std::remove(path.c_str());
+}
+
+TEST(ArenaTest, MapFileGrowsCapacityToFileSize) {
+    std::string contents(10000, 'a');
+    std::string path = write_temp_file(contents);
+
+    Arena arena = Arena::map_file(path.c_str(), Arena::FileMode::CopyOnWrite);
+    ASSERT_NE(arena.data(), nullptr);
+    EXPECT_GE(arena.capacity(), contents.size());
+    EXPECT_EQ(arena.data()[9999], 'a');
+
+    std::remove(path.c_str());
+}
+
+TEST(ArenaTest, MapMissingFile) {
+    Arena arena = Arena::map_file("/nonexistent/arena/file");
+    EXPECT_EQ(arena.data(), nullptr);
+    EXPECT_EQ(arena.capacity(), 0);
+    EXPECT_EQ(arena.allocate(1, 1), nullptr);
+}
+
+// SNAPSHOTS
+
+TEST(ArenaTest, SaveAndLoadSnapshot) {
+    std::string path = testing::TempDir() + "arena_snapshot_" + std::to_string(std::rand()) + ".bin";
+
+    Arena arena(4096);
+    int* values = arena.allocate<int>(100);
+    ASSERT_NE(values, nullptr);
+    for (int i = 0; i < 100; ++i)
+        values[i] = i * i;
+    ASSERT_TRUE(arena.save(path.c_str()));
+
+    Arena restored = Arena::load(path.c_str());
+    ASSERT_NE(restored.data(), nullptr);
+    EXPECT_NE(restored.data(), arena.data());
+    EXPECT_EQ(restored.used(), arena.used());
+    EXPECT_GE(restored.capacity(), arena.capacity());
+    EXPECT_EQ(std::memcmp(restored.data(), values, 100 * sizeof(int)), 0);
+
+    // The restored arena keeps allocating after the snapshot and resets to it
+    void* p = restored.allocate(16, 8);
+    ASSERT_NE(p, nullptr);
+    EXPECT_GE(static_cast<char*>(p), restored.data() + arena.used());
+    restored.reset();
+    EXPECT_EQ(restored.used(), arena.used());
+
+    std::remove(path.c_str());
+}
+
+TEST(ArenaTest, SaveEmptyArena) {
+    std::string path = testing::TempDir() + "arena_snapshot_" + std::to_string(std::rand()) + ".bin";
+
+    Arena arena(1024);
+    ASSERT_TRUE(arena.save(path.c_str()));
+
+    Arena restored = Arena::load(path.c_str());
+    ASSERT_NE(restored.data(), nullptr);
+    EXPECT_EQ(restored.used(), 0);
+    EXPECT_GE(restored.capacity(), 1024);
+
+    std::remove(path.c_str());
+}
+
+TEST(ArenaTest, LoadRejectsInvalidSnapshot) {
+    std::string path = write_temp_file(std::string(8192, 'z'));
+
+    Arena arena = Arena::load(path.c_str());
+    EXPECT_EQ(arena.data(), nullptr);
+    EXPECT_EQ(arena.capacity(), 0);
+    EXPECT_EQ(Arena::load("/nonexistent/arena/snapshot").data(), nullptr);
+
+    std::remove(path.c_str());
+}
+#endif
+
+// FREEZING
+
+TEST(ArenaTest, MapAnonymous) {
+    Arena arena = Arena::map_anonymous(10000);
+    ASSERT_NE(arena.data(), nullptr);
+    EXPECT_GE(arena.capacity(), 10000);
+    EXPECT_EQ(arena.used(), 0);
+
+    char* p = static_cast<char*>(arena.allocate(100, 8));
+    ASSERT_NE(p, nullptr);
+    EXPECT_EQ(p[99], 0);
+}
+
+TEST(ArenaTest, FreezeMakesArenaImmutable) {
+    Arena arena(1024);
+    int* value = arena.allocate<int>();
+    *value = 42;
+
+    // Heap arenas cannot be protected, only marked
+    EXPECT_FALSE(arena.freeze());
+    EXPECT_TRUE(arena.is_frozen());
+
+    size_t used = arena.used();
+    EXPECT_EQ(arena.allocate(8, 8), nullptr);
+    EXPECT_FALSE(arena.resize(value, sizeof(int), 2 * sizeof(int)));
+    arena.reset();
+    EXPECT_EQ(arena.used(), used);
+    EXPECT_EQ(*value, 42);
+}
+
+TEST(ArenaTest, FreezeProtectsMappedPages) {
+    Arena arena = Arena::map_anonymous(1 << 16);
+    int* values = arena.allocate<int>(1000);
+    ASSERT_NE(values, nullptr);
+    for (int i = 0; i < 1000; ++i)
+        values[i] = i;
+
+    EXPECT_TRUE(arena.freeze());
+    EXPECT_TRUE(arena.is_frozen());
+    EXPECT_EQ(values[999], 999);
+    EXPECT_EQ(arena.allocate(8, 8), nullptr);
+
+#if GTEST_HAS_DEATH_TEST
+    EXPECT_DEATH(values[0] = 1, "");
+#endif
+}
+
+TEST(ArenaTest, FreezeEmptyMappedArena) {
+    Arena arena = Arena::map_anonymous(4096);
+    EXPECT_FALSE(arena.freeze());
+    EXPECT_TRUE(arena.is_frozen());
+    EXPECT_EQ(arena.allocate(1, 1), nullptr);
+}
+
+TEST(ArenaTest, FrozenStateMoves) {
+    Arena arena = Arena::map_anonymous(4096);
+    arena.allocate(16, 8);
+    arena.freeze();
+
+    Arena moved(std::move(arena));
+    EXPECT_TRUE(moved.is_frozen());
+    EXPECT_FALSE(arena.is_frozen());
+}
+
+// FORKING
+
+#if defined(__linux__)
+TEST(ArenaTest, ForkSharesContents) {
+    Arena parent = Arena::map_forkable(1 << 20);
+    ASSERT_TRUE(parent.is_forkable());
+    int* values = parent.allocate<int>(1000);
+    for (int i = 0; i < 1000; ++i)
+        values[i] = i;
+
+    Arena child = parent.fork();
+    ASSERT_NE(child.data(), nullptr);
+    EXPECT_FALSE(child.is_forkable());
+    EXPECT_EQ(child.used(), parent.used());
+    EXPECT_EQ(child.capacity(), parent.capacity());
+
+    const int* seen = reinterpret_cast<const int*>(child.data() + (reinterpret_cast<char*>(values) - parent.data()));
+    EXPECT_NE(seen, values);
+    EXPECT_EQ(seen[999], 999);
+}
+
+TEST(ArenaTest, ForkWritesStayPrivate) {
+    Arena parent = Arena::map_forkable(1 << 16);
+    int* value = parent.allocate<int>();
+    *value = 1;
+    size_t offset = static_cast<size_t>(reinterpret_cast<char*>(value) - parent.data());
+
+    {
+        Arena child = parent.fork();
+        int* speculative = reinterpret_cast<int*>(child.data() + offset);
+        *speculative = 2;
+
+        // Both sides bump independently from the fork point
+        void* a = parent.allocate(64, 8);
+        void* b = child.allocate(64, 8);
+        EXPECT_EQ(static_cast<char*>(a) - parent.data(), static_cast<char*>(b) - child.data());
+
+        EXPECT_EQ(*value, 1);
+        EXPECT_EQ(*speculative, 2);
+    }
+
+    // Discarding the child leaves the parent untouched
+    EXPECT_EQ(*value, 1);
+}
+
+TEST(ArenaTest, ForkCommitByMove) {
+    Arena arena = Arena::map_forkable(1 << 16);
+    int* value = arena.allocate<int>();
+    *value = 1;
+    size_t offset = static_cast<size_t>(reinterpret_cast<char*>(value) - arena.data());
+
+    Arena child = arena.fork();
+    *reinterpret_cast<int*>(child.data() + offset) = 2;
+    size_t used = child.used();
+
+    arena = std::move(child);
+    EXPECT_EQ(*reinterpret_cast<int*>(arena.data() + offset), 2);
+    EXPECT_EQ(arena.used(), used);
+
+    // The fork point is the new reset position
+    arena.allocate(16, 8);
+    arena.reset();
+    EXPECT_EQ(arena.used(), used);
+}
+
+TEST(ArenaTest, ForkOfFrozenParent) {
+    Arena parent = Arena::map_forkable(1 << 16);
+    int* value = parent.allocate<int>();
+    *value = 7;
+    EXPECT_TRUE(parent.freeze());
+
+    Arena child = parent.fork();
+    ASSERT_NE(child.data(), nullptr);
+    EXPECT_FALSE(child.is_frozen());
+    int* copy = reinterpret_cast<int*>(child.data() + (reinterpret_cast<char*>(value) - parent.data()));
+    *copy = 8;
+    EXPECT_EQ(*value, 7);
+    EXPECT_NE(child.allocate(8, 8), nullptr);
+}
+#endif
+
+TEST(ArenaTest, ForkRequiresForkableArena) {
+    Arena heap(1024);
+    EXPECT_FALSE(heap.is_forkable());
+    EXPECT_EQ(heap.fork().data(), nullptr);
+
+    Arena mapped = Arena::map_anonymous(4096);
+    EXPECT_EQ(mapped.fork().data(), nullptr);
+}
+
 // TYPED ALLOCATION
 
 TEST(ArenaTest, TypedAllocation) {
@@ -188,6 +634,23 @@ TEST(ArenaTest, MixedSizeAllocations) {
     }
 }
 
+// STATISTICS
+
+TEST(ArenaTest, StatsCompiledOutByDefault) {
+    Arena arena(1024);
+    arena.allocate(16, 8);
+    EXPECT_FALSE(stats_enabled);
+    EXPECT_EQ(arena.stats().allocations, 0);
+    EXPECT_TRUE(std::is_empty_v<ArenaCounters>);
+
+    // The empty member must not take space either (MSVC needs its own attribute)
+    struct WithCounters {
+        char byte;
+        QUANTA_NO_UNIQUE_ADDRESS ArenaCounters counters;
+    };
+    EXPECT_EQ(sizeof(WithCounters), sizeof(char));
+}
+
 // MOVE SEMANTICS
 
 TEST(ArenaTest, MoveConstruction) {
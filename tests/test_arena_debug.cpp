@@ -0,0 +1,224 @@
+// Built as its own executable: the debug configuration must be the same in
+// every translation unit of a program.
+#define QUANTA_ARENA_DEBUG 1
+#define QUANTA_ARENA_GUARD_PAGES 1
+
+#include <gtest/gtest.h>
+#include "quanta/Arena.hpp"
+#include "quanta/ArenaPool.hpp"
+#include "quanta/GrowingArena.hpp"
+
+#include <cstdint>
+#include <cstring>
+
+using namespace quanta;
+
+namespace {
+
+// Poisoned under AddressSanitizer, filled with the poison byte otherwise
+bool looks_poisoned(const char* p) {
+    if constexpr (debug::asan)
+        return debug::is_poisoned(p);
+    return static_cast<unsigned char>(*p) == debug::poison_byte;
+}
+
+} // namespace
+
+// REDZONES
+
+TEST(ArenaDebugTest, ConfigurationIsActive) {
+    EXPECT_TRUE(debug::enabled);
+    EXPECT_TRUE(debug::guard_pages);
+    EXPECT_EQ(debug::redzone, 16);
+}
+
+TEST(ArenaDebugTest, AllocationsAreSeparatedByRedzones) {
+    Arena arena(1024);
+    char* a = static_cast<char*>(arena.allocate(10, 1));
+    char* b = static_cast<char*>(arena.allocate(10, 1));
+    ASSERT_NE(a, nullptr);
+    ASSERT_NE(b, nullptr);
+
+    EXPECT_GE(b - a, 10 + static_cast<ptrdiff_t>(debug::redzone));
+    EXPECT_EQ(arena.used(), 2 * (10 + debug::redzone));
+    EXPECT_TRUE(looks_poisoned(a + 10));
+}
+
+TEST(ArenaDebugTest, RedzoneCountsAgainstCapacity) {
+    Arena arena(64);
+    EXPECT_EQ(arena.allocate(64, 1), nullptr);
+    EXPECT_NE(arena.allocate(64 - debug::redzone, 1), nullptr);
+}
+
+TEST(ArenaDebugTest, ResetPoisonsMemory) {
+    Arena arena(1024);
+    char* p = static_cast<char*>(arena.allocate(100, 1));
+    std::memset(p, 'x', 100);
+
+    arena.reset();
+    EXPECT_EQ(arena.used(), 0);
+    EXPECT_TRUE(looks_poisoned(p));
+    EXPECT_TRUE(looks_poisoned(p + 99));
+}
+
+TEST(ArenaDebugTest, ResizeMovesRedzone) {
+    Arena arena(1024);
+    char* p = static_cast<char*>(arena.allocate(16, 1));
+
+    ASSERT_TRUE(arena.resize(p, 16, 64));
+    std::memset(p, 'y', 64);
+    EXPECT_EQ(arena.used(), 64 + debug::redzone);
+    EXPECT_TRUE(looks_poisoned(p + 64));
+
+    ASSERT_TRUE(arena.resize(p, 64, 8));
+    EXPECT_TRUE(looks_poisoned(p + 8));
+
+    arena.deallocate(p, 8);
+    EXPECT_EQ(arena.used(), 0);
+}
+
+TEST(ArenaDebugTest, SubArenaSliceReturnedToParent) {
+    Arena parent(1024);
+    {
+        Arena child = parent.sub_arena(256);
+        ASSERT_NE(child.data(), nullptr);
+        char* p = static_cast<char*>(child.allocate(32, 1));
+        ASSERT_NE(p, nullptr);
+        std::memset(p, 'z', 32);
+    }
+    EXPECT_EQ(parent.used(), 0);
+}
+
+TEST(ArenaDebugTest, TypedAllocationStillAligned) {
+    Arena arena(1024);
+    arena.allocate(1, 1);
+    double* d = arena.allocate<double>(4);
+    ASSERT_NE(d, nullptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(d) % alignof(double), 0u);
+    d[3] = 1.0;
+}
+
+TEST(ArenaDebugTest, PoolArenasAreWarmed) {
+    constexpr size_t capacity = 64 << 10;
+    ArenaPool pool({{capacity, 1}});
+    auto lease = pool.acquire(capacity);
+    ASSERT_TRUE(lease);
+
+    // The warming allocation leaves room for its redzone, so it succeeds and
+    // reset() poisons everything it touched
+    EXPECT_TRUE(looks_poisoned(lease->data()));
+    EXPECT_TRUE(looks_poisoned(lease->data() + capacity - debug::redzone - 1));
+}
+
+// REDZONE CHECKS WITHOUT ASAN
+
+#if GTEST_HAS_DEATH_TEST
+TEST(ArenaDebugTest, OverrunReportedOnReset) {
+    if constexpr (!debug::check_redzones)
+        GTEST_SKIP() << "software redzone checks are off (ASan build or redzone too small)";
+
+    Arena arena(1024);
+    char* first = static_cast<char*>(arena.allocate(10, 1));
+    arena.allocate(10, 1);
+
+    // Not the newest allocation: found by walking the redzone chain
+    EXPECT_DEATH({ first[10] = 'x'; arena.reset(); }, "redzone");
+}
+
+TEST(ArenaDebugTest, OverrunReportedOnDeallocate) {
+    if constexpr (!debug::check_redzones)
+        GTEST_SKIP() << "software redzone checks are off (ASan build or redzone too small)";
+
+    Arena arena(1024);
+    char* p = static_cast<char*>(arena.allocate(10, 1));
+    EXPECT_DEATH({ p[12] = 'x'; arena.deallocate(p, 10); }, "redzone");
+}
+
+TEST(ArenaDebugTest, OverrunReportedOnResize) {
+    if constexpr (!debug::check_redzones)
+        GTEST_SKIP() << "software redzone checks are off (ASan build or redzone too small)";
+
+    Arena arena(1024);
+    char* p = static_cast<char*>(arena.allocate(10, 1));
+    EXPECT_DEATH({ p[10] = 'x'; arena.resize(p, 10, 20); }, "redzone");
+}
+
+TEST(ArenaDebugTest, OverrunReportedOnDestruction) {
+    if constexpr (!debug::check_redzones)
+        GTEST_SKIP() << "software redzone checks are off (ASan build or redzone too small)";
+
+    EXPECT_DEATH({
+        Arena arena(1024);
+        char* p = static_cast<char*>(arena.allocate(10, 1));
+        p[10] = 'x';
+    }, "redzone");
+}
+
+TEST(ArenaDebugTest, GrowingArenaOverrunReportedOnReset) {
+    if constexpr (!debug::check_redzones)
+        GTEST_SKIP() << "software redzone checks are off (ASan build or redzone too small)";
+
+    GrowingArena arena(4096);
+    arena.set_large_threshold(SIZE_MAX);
+    char* first = static_cast<char*>(arena.allocate(100, 1));
+    for (int i = 0; i < 100; ++i)
+        arena.allocate(100, 8);     // spills into further blocks
+
+    EXPECT_DEATH({ first[100] = 'x'; arena.reset(); }, "redzone");
+}
+#endif
+
+TEST(ArenaDebugTest, IntactRedzonesPassChecks) {
+    Arena arena(1024);
+    char* a = static_cast<char*>(arena.allocate(10, 1));
+    char* b = static_cast<char*>(arena.allocate(30, 8));
+    std::memset(a, 'a', 10);
+    std::memset(b, 'b', 30);
+    ASSERT_TRUE(arena.resize(b, 30, 40));
+    std::memset(b, 'b', 40);
+    arena.deallocate(b, 40);
+    arena.reset();
+    EXPECT_EQ(arena.used(), 0);
+}
+
+// GUARD PAGES
+
+TEST(ArenaDebugTest, GrowingArenaRedzonesAndReset) {
+    GrowingArena arena(4096);
+    arena.set_large_threshold(SIZE_MAX);
+
+    char* a = static_cast<char*>(arena.allocate(10, 1));
+    char* b = static_cast<char*>(arena.allocate(10, 1));
+    EXPECT_GE(b - a, 10 + static_cast<ptrdiff_t>(debug::redzone));
+    EXPECT_TRUE(looks_poisoned(a + 10));
+
+    arena.reset();
+    EXPECT_TRUE(looks_poisoned(a));
+    EXPECT_EQ(arena.allocate(10, 1), a);
+}
+
+TEST(ArenaDebugTest, GrowingArenaChainsGuardedBlocks) {
+    GrowingArena arena(4096);
+    arena.set_large_threshold(SIZE_MAX);
+
+    for (int i = 0; i < 100; ++i) {
+        char* p = static_cast<char*>(arena.allocate(1000, 8));
+        ASSERT_NE(p, nullptr);
+        std::memset(p, i, 1000);
+    }
+    EXPECT_GT(arena.block_count(), 1);
+}
+
+#if GTEST_HAS_DEATH_TEST
+TEST(ArenaDebugTest, GrowingArenaBlockEndsInGuardPage) {
+    GrowingArena arena(4096);
+    arena.set_large_threshold(SIZE_MAX);
+
+    // The first allocation starts the block, which runs right up to the guard page
+    char* p = static_cast<char*>(arena.allocate(1, 1));
+    ASSERT_NE(p, nullptr);
+    char* end = p + arena.capacity();
+
+    EXPECT_DEATH(*static_cast<volatile char*>(end) = 'x', "");
+}
+#endif
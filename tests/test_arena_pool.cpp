@@ -0,0 +1,201 @@
+#include <gtest/gtest.h>
+#include "quanta/ArenaPool.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace quanta;
+
+// CONSTRUCTION
+
+TEST(ArenaPoolTest, BucketsSortedAndWarm) {
+    ArenaPool pool({{4096, 2}, {1024, 4}});
+
+    ASSERT_EQ(pool.bucket_count(), 2);
+    EXPECT_EQ(pool.bucket_capacity(0), 1024);
+    EXPECT_EQ(pool.bucket_capacity(1), 4096);
+    EXPECT_EQ(pool.resident_bytes(), 4 * 1024 + 2 * 4096);
+}
+
+// CHECKOUT AND RETURN
+
+TEST(ArenaPoolTest, AcquirePicksSmallestFittingBucket) {
+    ArenaPool pool({{1024, 1}, {4096, 1}});
+
+    auto lease = pool.acquire(512);
+    ASSERT_TRUE(lease);
+    EXPECT_EQ(lease->capacity(), 1024);
+
+    auto big = pool.acquire(2000);
+    ASSERT_TRUE(big);
+    EXPECT_EQ(big->capacity(), 4096);
+}
+
+TEST(ArenaPoolTest, FallsBackToLargerBucket) {
+    ArenaPool pool({{1024, 1}, {4096, 1}});
+
+    auto first = pool.acquire(100);
+    auto second = pool.acquire(100);
+    ASSERT_TRUE(second);
+    EXPECT_EQ(second->capacity(), 4096);
+
+    auto third = pool.acquire(100);
+    EXPECT_FALSE(third);
+}
+
+TEST(ArenaPoolTest, TooLargeRequest) {
+    ArenaPool pool({{1024, 1}});
+
+    EXPECT_FALSE(pool.acquire(2048));
+}
+
+TEST(ArenaPoolTest, LeaseReturnsResetArena) {
+    ArenaPool pool({{1024, 1}});
+
+    Arena* first = nullptr;
+    {
+        auto lease = pool.acquire(1024);
+        ASSERT_TRUE(lease);
+        lease->allocate(500, 1);
+        first = &lease.arena();
+    }
+
+    auto lease = pool.acquire(1024);
+    ASSERT_TRUE(lease);
+    EXPECT_EQ(&lease.arena(), first);
+    EXPECT_EQ(lease->used(), 0);
+}
+
+TEST(ArenaPoolTest, LeaseMoveAndRelease) {
+    ArenaPool pool({{1024, 1}});
+
+    auto lease = pool.acquire(1);
+    ArenaPool::Lease moved(std::move(lease));
+    EXPECT_FALSE(lease);
+    ASSERT_TRUE(moved);
+
+    EXPECT_FALSE(pool.acquire(1));
+    moved.release();
+    EXPECT_FALSE(moved);
+    EXPECT_TRUE(pool.acquire(1));
+}
+
+// IDLE TRIM
+
+TEST(ArenaPoolTest, TrimReleasesIdleArenas) {
+    ArenaPool pool({{1024, 3}});
+
+    EXPECT_EQ(pool.trim(std::chrono::hours(1)), 0);
+    EXPECT_EQ(pool.trim(std::chrono::nanoseconds(-1)), 3);
+    EXPECT_EQ(pool.resident_bytes(), 0);
+
+    // Trimmed arenas come back on demand
+    auto lease = pool.acquire(1024);
+    ASSERT_TRUE(lease);
+    EXPECT_EQ(lease->capacity(), 1024);
+    EXPECT_NE(lease->allocate(1024, 1), nullptr);
+    EXPECT_EQ(pool.resident_bytes(), 1024);
+}
+
+TEST(ArenaPoolTest, TrimKeepsWarmMinimum) {
+    ArenaPool pool({{1024, 4}});
+
+    EXPECT_EQ(pool.trim(std::chrono::nanoseconds(-1), 1), 3);
+    EXPECT_EQ(pool.resident_bytes(), 1024);
+}
+
+TEST(ArenaPoolTest, TrimSkipsLeasedArenas) {
+    ArenaPool pool({{1024, 2}});
+
+    auto lease = pool.acquire(1);
+    EXPECT_EQ(pool.trim(std::chrono::nanoseconds(-1)), 1);
+    EXPECT_EQ(lease->capacity(), 1024);
+}
+
+// CONCURRENCY
+
+TEST(ArenaPoolTest, ConcurrentCheckout) {
+    constexpr int threads = 4;
+    constexpr int iterations = 10000;
+    ArenaPool pool({{256, 2}});
+    std::atomic<int> corrupted{0};
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&] {
+            for (int i = 0; i < iterations; ++i) {
+                auto lease = pool.acquire(64);
+                if (!lease)
+                    continue;
+                // A leased arena is exclusively ours: it must start empty
+                if (lease->used() != 0)
+                    ++corrupted;
+                lease->allocate(64, 8);
+            }
+        });
+    }
+    for (auto& w : workers)
+        w.join();
+
+    // Exhaustion is allowed with 4 threads on 2 arenas; corruption is not
+    EXPECT_EQ(corrupted.load(), 0);
+    auto a = pool.acquire(1);
+    auto b = pool.acquire(1);
+    EXPECT_TRUE(a);
+    EXPECT_TRUE(b);
+    EXPECT_FALSE(pool.acquire(1));
+    EXPECT_EQ(a->used(), 0);
+    EXPECT_EQ(b->used(), 0);
+    EXPECT_NE(&a.arena(), &b.arena());
+}
+
+TEST(ArenaPoolTest, CheckoutDuringTrimDoesNotFail) {
+    ArenaPool pool({{1024, 2}});
+    std::atomic<bool> done{false};
+    int failures = 0;
+
+    std::thread trimmer([&] {
+        while (!done.load())
+            pool.trim(std::chrono::nanoseconds(-1));
+    });
+
+    // Only one lease is held at a time, so an arena is always available
+    for (int i = 0; i < 20000; ++i) {
+        auto lease = pool.acquire(1024);
+        if (!lease)
+            ++failures;
+    }
+    done = true;
+    trimmer.join();
+
+    EXPECT_EQ(failures, 0);
+}
+
+TEST(ArenaPoolTest, CheckoutDuringOverlappingTrimsDoesNotFail) {
+    ArenaPool pool({{1024, 2}});
+    std::atomic<bool> done{false};
+    int failures = 0;
+
+    // Nothing is idle for an hour, so these only ever inspect and keep
+    std::vector<std::thread> trimmers;
+    for (int t = 0; t < 2; ++t) {
+        trimmers.emplace_back([&] {
+            while (!done.load())
+                pool.trim(std::chrono::hours(1));
+        });
+    }
+
+    for (int i = 0; i < 20000; ++i) {
+        auto lease = pool.acquire(1024);
+        if (!lease)
+            ++failures;
+    }
+    done = true;
+    for (auto& trimmer : trimmers)
+        trimmer.join();
+
+    EXPECT_EQ(failures, 0);
+    EXPECT_EQ(pool.resident_bytes(), 2u * 1024);
+}
@@ -0,0 +1,144 @@
+// Built as its own executable: the statistics configuration must be the
+// same in every translation unit of a program.
+#define QUANTA_ARENA_STATS 1
+
+#include <gtest/gtest.h>
+#include "quanta/Arena.hpp"
+#include "quanta/GrowingArena.hpp"
+
+#include <atomic>
+#include <thread>
+
+using namespace quanta;
+
+// ARENA
+
+TEST(ArenaStatsTest, Enabled) {
+    EXPECT_TRUE(stats_enabled);
+}
+
+TEST(ArenaStatsTest, CountsAllocations) {
+    Arena arena(1024);
+    arena.allocate(3, 1);
+    arena.allocate(8, 8);       // 5 bytes of padding
+    arena.allocate<int>(4);
+
+    ArenaStats stats = arena.stats();
+    EXPECT_EQ(stats.allocations, 3);
+    EXPECT_EQ(stats.bytes_requested, 3 + 8 + 16);
+    EXPECT_EQ(stats.bytes_consumed, arena.used());
+    EXPECT_EQ(stats.padding(), 5);
+    EXPECT_EQ(stats.peak_used, arena.used());
+    EXPECT_EQ(stats.blocks, 1);
+    EXPECT_EQ(stats.failures, 0);
+}
+
+TEST(ArenaStatsTest, CountsFailuresAndResets) {
+    Arena arena(64);
+    EXPECT_EQ(arena.allocate(128, 1), nullptr);
+    arena.allocate(48, 1);
+    arena.reset();
+    arena.allocate(16, 1);
+    arena.reset();
+
+    ArenaStats stats = arena.stats();
+    EXPECT_EQ(stats.failures, 1);
+    EXPECT_EQ(stats.resets, 2);
+    EXPECT_EQ(stats.allocations, 2);
+    EXPECT_EQ(stats.peak_used, 48);
+}
+
+TEST(ArenaStatsTest, CountsRejectedCalls) {
+    Arena arena(64);
+    EXPECT_EQ(arena.allocate(0, 1), nullptr);
+    EXPECT_EQ(arena.allocate(8, 3), nullptr);
+    EXPECT_EQ(arena.allocate<uint64_t>(SIZE_MAX / 4), nullptr);
+    arena.freeze();
+    EXPECT_EQ(arena.allocate(8, 8), nullptr);
+
+    EXPECT_EQ(arena.stats().failures, 4);
+    EXPECT_EQ(arena.stats().allocations, 0);
+}
+
+TEST(ArenaStatsTest, ResizeGrowthCounts) {
+    Arena arena(256);
+    void* p = arena.allocate(16, 1);
+    ASSERT_TRUE(arena.resize(p, 16, 100));
+
+    ArenaStats stats = arena.stats();
+    EXPECT_EQ(stats.bytes_requested, 100);
+    EXPECT_EQ(stats.peak_used, 100);
+}
+
+TEST(ArenaStatsTest, MoveCarriesCounters) {
+    Arena a(256);
+    a.allocate(10, 1);
+
+    Arena b(std::move(a));
+    EXPECT_EQ(b.stats().allocations, 1);
+    EXPECT_EQ(a.stats().allocations, 0);
+}
+
+TEST(ArenaStatsTest, ReadableFromAnotherThread) {
+    Arena arena(1 << 20);
+    std::atomic<bool> done{false};
+    size_t last_seen = 0;
+    bool monotonic = true;
+
+    std::thread reader([&] {
+        while (!done.load()) {
+            size_t n = arena.stats().allocations;
+            if (n < last_seen)
+                monotonic = false;
+            last_seen = n;
+        }
+    });
+
+    for (int i = 0; i < 10000; ++i)
+        arena.allocate(16, 8);
+    done = true;
+    reader.join();
+
+    EXPECT_TRUE(monotonic);
+    EXPECT_EQ(arena.stats().allocations, 10000);
+}
+
+// GROWING ARENA
+
+TEST(ArenaStatsTest, GrowingArenaCountsBlocks) {
+    GrowingArena arena(1024);
+    arena.set_large_threshold(SIZE_MAX);
+    for (int i = 0; i < 10; ++i)
+        arena.allocate(500, 8);
+
+    ArenaStats stats = arena.stats();
+    EXPECT_EQ(stats.allocations, 10);
+    EXPECT_EQ(stats.blocks, arena.block_count());
+    EXPECT_EQ(stats.bytes_requested, 5000);
+    EXPECT_EQ(stats.peak_used, arena.used());
+
+    arena.reset();
+    EXPECT_EQ(arena.stats().resets, 1);
+    EXPECT_EQ(arena.stats().peak_used, stats.peak_used);
+}
+
+TEST(ArenaStatsTest, GrowingArenaLargeAllocations) {
+    GrowingArena arena(4096);
+    arena.allocate(100000, 8);
+
+    ArenaStats stats = arena.stats();
+    EXPECT_EQ(stats.allocations, 1);
+    EXPECT_EQ(stats.blocks, 1);
+    EXPECT_EQ(stats.bytes_requested, 100000);
+    EXPECT_GE(stats.bytes_consumed, 100000);
+}
+
+TEST(ArenaStatsTest, GrowingArenaCountsRejectedCalls) {
+    GrowingArena arena(1024);
+    EXPECT_EQ(arena.allocate(0, 1), nullptr);
+    EXPECT_EQ(arena.allocate(8, 3), nullptr);
+    EXPECT_EQ(arena.allocate(SIZE_MAX - 8, 8), nullptr);
+    EXPECT_EQ(arena.allocate<uint64_t>(SIZE_MAX / 4), nullptr);
+
+    EXPECT_EQ(arena.stats().failures, 4);
+}
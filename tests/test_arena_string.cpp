@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+#include "quanta/ArenaString.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <string>
+#include <version>
+#ifdef __cpp_lib_format
+#include <format>
+#endif
+
+using namespace quanta;
+
+// ARENA STRING
+
+TEST(ArenaStringTest, ShortStringsStayInline) {
+    Arena arena(1024);
+
+    auto s = ArenaString::copy(arena, "short");
+    ASSERT_TRUE(s.has_value());
+    EXPECT_TRUE(s->is_inline());
+    EXPECT_EQ(*s, "short");
+    EXPECT_EQ(arena.used(), 0);
+}
+
+TEST(ArenaStringTest, LongStringsLiveInArena) {
+    Arena arena(1024);
+    std::string text(100, 'x');
+
+    auto s = ArenaString::copy(arena, text);
+    ASSERT_TRUE(s.has_value());
+    EXPECT_FALSE(s->is_inline());
+    EXPECT_EQ(s->view(), text);
+    EXPECT_TRUE(arena.owns(const_cast<char*>(s->data())));
+}
+
+TEST(ArenaStringTest, CopyOutOfMemory) {
+    Arena arena(16);
+    std::string text(64, 'x');
+
+    EXPECT_FALSE(ArenaString::copy(arena, text).has_value());
+}
+
+TEST(ArenaStringTest, InlineCopiesAreIndependent) {
+    Arena arena(64);
+
+    auto a = ArenaString::copy(arena, "abc");
+    ArenaString b = *a;
+    EXPECT_EQ(a->view(), b.view());
+    EXPECT_NE(a->data(), b.data());
+}
+
+// BUILDER
+
+TEST(ArenaStringBuilderTest, AppendAndFreeze) {
+    Arena arena(1024);
+    ArenaStringBuilder builder(arena);
+
+    builder.append("hello");
+    builder.push_back(',');
+    builder += " world";
+
+    std::string_view v = builder.freeze();
+    EXPECT_EQ(v, "hello, world");
+    EXPECT_EQ(arena.used(), v.size());
+    EXPECT_EQ(builder.size(), 0);
+}
+
+TEST(ArenaStringBuilderTest, GrowsInPlaceAtTail) {
+    Arena arena(4096);
+    ArenaStringBuilder builder(arena, 8);
+    const char* start = builder.view().data();
+
+    for (int i = 0; i < 100; ++i)
+        builder.append("0123456789");
+
+    EXPECT_EQ(builder.view().data(), start);
+    EXPECT_EQ(arena.used(), 1000);
+}
+
+TEST(ArenaStringBuilderTest, RelocatesWhenNotAtTail) {
+    Arena arena(4096);
+    ArenaStringBuilder builder(arena, 8);
+    builder.append("abcdefgh");
+
+    arena.allocate(16, 1);
+    builder.append("ijklmnop");
+
+    EXPECT_EQ(builder.view(), "abcdefghijklmnop");
+    EXPECT_FALSE(builder.failed());
+}
+
+TEST(ArenaStringBuilderTest, FailureIsSticky) {
+    Arena arena(16);
+    ArenaStringBuilder builder(arena);
+
+    EXPECT_TRUE(builder.append("0123456789"));
+    EXPECT_FALSE(builder.append("0123456789"));
+    EXPECT_TRUE(builder.failed());
+    EXPECT_FALSE(builder.push_back('x'));
+    EXPECT_EQ(builder.view(), "0123456789");
+}
+
+TEST(ArenaStringBuilderTest, BuildShortReturnsArenaBytes) {
+    Arena arena(1024);
+    ArenaStringBuilder builder(arena);
+
+    builder.append("tiny");
+    ArenaString s = builder.build();
+    EXPECT_TRUE(s.is_inline());
+    EXPECT_EQ(s, "tiny");
+    EXPECT_EQ(arena.used(), 0);
+}
+
+TEST(ArenaStringBuilderTest, BuildLong) {
+    Arena arena(1024);
+    ArenaStringBuilder builder(arena);
+    std::string text(40, 'y');
+
+    builder.append(text);
+    ArenaString s = builder.build();
+    EXPECT_FALSE(s.is_inline());
+    EXPECT_EQ(s, text);
+    EXPECT_EQ(arena.used(), text.size());
+}
+
+TEST(ArenaStringBuilderTest, OutputIterator) {
+    static_assert(std::output_iterator<ArenaStringBuilder::iterator, char>);
+
+    Arena arena(1024);
+    ArenaStringBuilder builder(arena);
+    std::string_view text = "copied through iterator";
+
+    std::copy(text.begin(), text.end(), builder.out());
+    EXPECT_EQ(builder.freeze(), text);
+}
+
+#ifdef __cpp_lib_format
+TEST(ArenaStringBuilderTest, FormatTo) {
+    Arena arena(1024);
+    ArenaStringBuilder builder(arena);
+
+    std::format_to(builder.out(), "{}-{}", 42, "answer");
+    EXPECT_EQ(builder.freeze(), "42-answer");
+}
+#endif
@@ -0,0 +1,184 @@
+#include <gtest/gtest.h>
+#include "quanta/BuddyAllocator.hpp"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace quanta;
+
+// CONSTRUCTION
+
+TEST(BuddyAllocatorTest, Construction) {
+    Arena arena(1 << 20);
+    BuddyAllocator buddy(arena, 1 << 16, 64);
+
+    EXPECT_EQ(buddy.capacity(), 1 << 16);
+    EXPECT_EQ(buddy.available(), 1 << 16);
+    EXPECT_EQ(buddy.used(), 0);
+    EXPECT_GT(arena.used(), size_t{1} << 16);
+}
+
+TEST(BuddyAllocatorTest, RegionRoundedDownToPowerOfTwo) {
+    Arena arena(1 << 20);
+    BuddyAllocator buddy(arena, 100000, 64);
+
+    EXPECT_EQ(buddy.capacity(), 65536);
+}
+
+TEST(BuddyAllocatorTest, ArenaTooSmall) {
+    Arena arena(1024);
+    BuddyAllocator buddy(arena, 1 << 16);
+
+    EXPECT_EQ(buddy.capacity(), 0);
+    EXPECT_EQ(buddy.allocate(1), nullptr);
+}
+
+// ALLOCATION
+
+TEST(BuddyAllocatorTest, RoundsUpToPowerOfTwoBlocks) {
+    Arena arena(1 << 20);
+    BuddyAllocator buddy(arena, 4096, 64);
+
+    ASSERT_NE(buddy.allocate(100), nullptr);
+    EXPECT_EQ(buddy.used(), 128);
+    EXPECT_EQ(buddy.block_size(100), 128);
+    EXPECT_EQ(buddy.block_size(1), 64);
+}
+
+TEST(BuddyAllocatorTest, WholeRegion) {
+    Arena arena(1 << 20);
+    BuddyAllocator buddy(arena, 4096, 64);
+
+    void* p = buddy.allocate(4096);
+    ASSERT_NE(p, nullptr);
+    EXPECT_EQ(buddy.available(), 0);
+    EXPECT_EQ(buddy.allocate(1), nullptr);
+
+    buddy.deallocate(p);
+    EXPECT_EQ(buddy.available(), 4096);
+}
+
+TEST(BuddyAllocatorTest, TooLarge) {
+    Arena arena(1 << 20);
+    BuddyAllocator buddy(arena, 4096, 64);
+
+    EXPECT_EQ(buddy.allocate(4097), nullptr);
+    EXPECT_EQ(buddy.allocate(0), nullptr);
+}
+
+TEST(BuddyAllocatorTest, BlocksAreAligned) {
+    Arena arena(1 << 20);
+    BuddyAllocator buddy(arena, 1 << 16, 64);
+
+    buddy.allocate(64);
+    for (size_t align : {8, 64, 256, 1024, 4096}) {
+        void* p = buddy.allocate(10, align);
+        ASSERT_NE(p, nullptr);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % align, 0);
+    }
+}
+
+TEST(BuddyAllocatorTest, ExhaustMinimumBlocks) {
+    Arena arena(1 << 20);
+    BuddyAllocator buddy(arena, 4096, 64);
+
+    std::vector<void*> blocks;
+    while (void* p = buddy.allocate(64))
+        blocks.push_back(p);
+
+    EXPECT_EQ(blocks.size(), 64);
+    std::sort(blocks.begin(), blocks.end());
+    EXPECT_EQ(std::adjacent_find(blocks.begin(), blocks.end()), blocks.end());
+}
+
+// FREE AND COALESCE
+
+TEST(BuddyAllocatorTest, BuddiesMerge) {
+    Arena arena(1 << 20);
+    BuddyAllocator buddy(arena, 4096, 64);
+
+    void* a = buddy.allocate(2048);
+    void* b = buddy.allocate(2048);
+    ASSERT_NE(b, nullptr);
+
+    buddy.deallocate(a);
+    buddy.deallocate(b);
+
+    // Only possible if both halves merged back into the root
+    EXPECT_NE(buddy.allocate(4096), nullptr);
+}
+
+TEST(BuddyAllocatorTest, NonBuddiesDoNotMerge) {
+    Arena arena(1 << 20);
+    BuddyAllocator buddy(arena, 4096, 1024);
+
+    void* a = buddy.allocate(1024);
+    void* b = buddy.allocate(1024);
+    void* c = buddy.allocate(1024);
+    void* d = buddy.allocate(1024);
+    ASSERT_NE(d, nullptr);
+
+    // b and c are adjacent but not buddies
+    buddy.deallocate(b);
+    buddy.deallocate(c);
+    EXPECT_EQ(buddy.allocate(2048), nullptr);
+
+    buddy.deallocate(a);
+    EXPECT_NE(buddy.allocate(2048), nullptr);
+    (void)d;
+}
+
+TEST(BuddyAllocatorTest, DoubleFreeIgnored) {
+    Arena arena(1 << 20);
+    BuddyAllocator buddy(arena, 4096, 64);
+
+    void* a = buddy.allocate(64);
+    buddy.allocate(64);
+    buddy.deallocate(a);
+    size_t available = buddy.available();
+
+    buddy.deallocate(a);
+    EXPECT_EQ(buddy.available(), available);
+}
+
+TEST(BuddyAllocatorTest, ForeignPointerIgnored) {
+    Arena arena(1 << 20);
+    BuddyAllocator buddy(arena, 4096, 64);
+    int local = 0;
+
+    buddy.deallocate(&local);
+    buddy.deallocate(nullptr);
+    EXPECT_EQ(buddy.available(), 4096);
+}
+
+// STRESS
+
+TEST(BuddyAllocatorTest, RandomAllocFreeReturnsToFull) {
+    Arena arena(1 << 22);
+    BuddyAllocator buddy(arena, 1 << 20, 32);
+    std::mt19937 rng(42);
+    std::vector<std::pair<char*, size_t>> live;
+
+    for (int i = 0; i < 20000; ++i) {
+        if (live.empty() || rng() % 3 != 0) {
+            size_t size = 1 + rng() % 4000;
+            char* p = static_cast<char*>(buddy.allocate(size));
+            if (p != nullptr) {
+                std::fill(p, p + size, static_cast<char>(i));
+                live.emplace_back(p, size);
+            }
+        } else {
+            size_t k = rng() % live.size();
+            buddy.deallocate(live[k].first);
+            live[k] = live.back();
+            live.pop_back();
+        }
+    }
+
+    for (auto& [p, size] : live)
+        buddy.deallocate(p);
+
+    EXPECT_EQ(buddy.available(), buddy.capacity());
+    EXPECT_NE(buddy.allocate(1 << 20), nullptr);
+}
@@ -0,0 +1,196 @@
+#include <gtest/gtest.h>
+#include "quanta/Composable.hpp"
+#include "quanta/Arena.hpp"
+#include "quanta/BuddyAllocator.hpp"
+#include "quanta/TlsfAllocator.hpp"
+
+#include <cstring>
+
+using namespace quanta;
+
+// CONCEPTS
+
+static_assert(OwningAllocator<Arena>);
+static_assert(OwningAllocator<BuddyAllocator>);
+static_assert(OwningAllocator<TlsfAllocator>);
+static_assert(OwningAllocator<NullAllocator>);
+static_assert(Allocator<Mallocator>);
+static_assert(!OwningAllocator<Mallocator>);
+static_assert(OwningAllocator<AllocatorRef<TlsfAllocator>>);
+static_assert(!OwningAllocator<Fallback<Arena, Mallocator>>);
+static_assert(OwningAllocator<Fallback<Arena, Arena>>);
+
+TEST(ComposableTest, ArenaDeallocateRewindsLastOnly) {
+    Arena arena(1024);
+
+    void* a = arena.allocate(100, 1);
+    void* b = arena.allocate(100, 1);
+
+    arena.deallocate(a, 100);
+    EXPECT_EQ(arena.used(), 200);
+    arena.deallocate(b, 100);
+    EXPECT_EQ(arena.used(), 100);
+}
+
+// FALLBACK
+
+TEST(ComposableTest, FallbackUsesSecondaryWhenPrimaryFull) {
+    Fallback<Arena, Mallocator> alloc(Arena(128), Mallocator());
+
+    void* a = alloc.allocate(100, 8);
+    void* b = alloc.allocate(100, 8);
+    ASSERT_NE(a, nullptr);
+    ASSERT_NE(b, nullptr);
+
+    EXPECT_TRUE(alloc.primary().owns(a));
+    EXPECT_FALSE(alloc.primary().owns(b));
+
+    alloc.deallocate(b, 100);
+    alloc.deallocate(a, 100);
+    EXPECT_EQ(alloc.primary().used(), 0);
+}
+
+TEST(ComposableTest, FallbackOwns) {
+    Fallback<Arena, Arena> alloc(Arena(64), Arena(64));
+
+    void* a = alloc.allocate(64, 1);
+    void* b = alloc.allocate(64, 1);
+    EXPECT_TRUE(alloc.owns(a));
+    EXPECT_TRUE(alloc.owns(b));
+    EXPECT_EQ(alloc.allocate(1, 1), nullptr);
+}
+
+// SEGREGATOR
+
+TEST(ComposableTest, SegregatorRoutesBySize) {
+    Segregator<64, Arena, Arena> alloc(Arena(1024), Arena(1024));
+
+    void* small = alloc.allocate(64, 8);
+    void* large = alloc.allocate(65, 8);
+
+    EXPECT_TRUE(alloc.small().owns(small));
+    EXPECT_TRUE(alloc.large().owns(large));
+    EXPECT_TRUE(alloc.owns(small));
+
+    alloc.deallocate(large, 65);
+    EXPECT_EQ(alloc.large().used(), 0);
+    EXPECT_EQ(alloc.small().used(), 64);
+}
+
+TEST(ComposableTest, SegregatorOverReferences) {
+    Arena arena(1 << 20);
+    TlsfAllocator tlsf(arena, 1 << 16);
+    BuddyAllocator buddy(arena, 1 << 16);
+
+    Segregator<256, AllocatorRef<TlsfAllocator>, AllocatorRef<BuddyAllocator>> alloc{
+        AllocatorRef<TlsfAllocator>(tlsf), AllocatorRef<BuddyAllocator>(buddy)};
+
+    void* a = alloc.allocate(32, 8);
+    void* b = alloc.allocate(1000, 8);
+    EXPECT_TRUE(tlsf.owns(a));
+    EXPECT_TRUE(buddy.owns(b));
+
+    alloc.deallocate(a, 32);
+    alloc.deallocate(b, 1000);
+    EXPECT_EQ(tlsf.used(), 0);
+    EXPECT_EQ(buddy.used(), 0);
+}
+
+// BUCKETIZER
+
+TEST(ComposableTest, BucketizerSizeClasses) {
+    Bucketizer<Arena, 0, 256, 64> alloc(size_t{1024});
+    EXPECT_EQ(decltype(alloc)::bucket_count, 4);
+
+    void* a = alloc.allocate(1, 1);
+    void* b = alloc.allocate(64, 1);
+    void* c = alloc.allocate(65, 1);
+    void* d = alloc.allocate(256, 1);
+
+    EXPECT_TRUE(alloc.bucket(0).owns(a));
+    EXPECT_TRUE(alloc.bucket(0).owns(b));
+    EXPECT_TRUE(alloc.bucket(1).owns(c));
+    EXPECT_TRUE(alloc.bucket(3).owns(d));
+    EXPECT_TRUE(alloc.owns(d));
+
+    EXPECT_EQ(alloc.allocate(257, 1), nullptr);
+}
+
+// AFFIX
+
+TEST(ComposableTest, AffixPrefixHeader) {
+    struct Header {
+        uint32_t tag = 7;
+    };
+    AffixAllocator<Arena, Header> alloc(Arena(1024));
+
+    void* p = alloc.allocate(40, 8);
+    ASSERT_NE(p, nullptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % alignof(std::max_align_t), 0);
+    EXPECT_EQ(decltype(alloc)::prefix(p).tag, 7u);
+
+    decltype(alloc)::prefix(p).tag = 9;
+    EXPECT_EQ(decltype(alloc)::prefix(p).tag, 9u);
+
+    alloc.deallocate(p, 40);
+    EXPECT_EQ(alloc.parent().used(), 0);
+}
+
+TEST(ComposableTest, AffixCanariesDetectOverrun) {
+    using Guarded = AffixAllocator<Arena, Canary, Canary>;
+    Guarded alloc(Arena(1024));
+
+    char* p = static_cast<char*>(alloc.allocate(20, 8));
+    ASSERT_NE(p, nullptr);
+    EXPECT_TRUE(Guarded::prefix(p).intact());
+    EXPECT_TRUE(Guarded::suffix(p, 20).intact());
+
+    std::memset(p, 0, 20);
+    EXPECT_TRUE(Guarded::suffix(p, 20).intact());
+
+    std::memset(p, 0, 28);  // overrun into the suffix guard
+    EXPECT_FALSE(Guarded::suffix(p, 20).intact());
+    EXPECT_TRUE(Guarded::prefix(p).intact());
+}
+
+TEST(ComposableTest, AffixRejectsOverAlignment) {
+    AffixAllocator<Arena, Canary> alloc(Arena(1024));
+    EXPECT_EQ(alloc.allocate(8, 256), nullptr);
+}
+
+// STATS
+
+TEST(ComposableTest, StatsCountTraffic) {
+    StatsAllocator<Arena> alloc(Arena(256));
+
+    void* a = alloc.allocate(100, 8);
+    void* b = alloc.allocate(100, 8);
+    alloc.allocate(100, 8);  // fails
+
+    alloc.deallocate(b, 100);
+    alloc.deallocate(a, 100);
+
+    const auto& s = alloc.stats();
+    EXPECT_EQ(s.allocations, 2);
+    EXPECT_EQ(s.failures, 1);
+    EXPECT_EQ(s.deallocations, 2);
+    EXPECT_EQ(s.bytes_allocated, 200);
+    EXPECT_EQ(s.bytes_live, 0);
+    EXPECT_EQ(s.peak_bytes_live, 200);
+}
+
+TEST(ComposableTest, NestedComposition) {
+    using Small = StatsAllocator<Arena>;
+    using Composite = Segregator<128, Small, Fallback<Arena, Mallocator>>;
+
+    Composite alloc(Small(Arena(1024)), Fallback<Arena, Mallocator>(Arena(1024), Mallocator()));
+
+    void* a = alloc.allocate(64, 8);
+    void* b = alloc.allocate(4096, 8);
+    ASSERT_NE(a, nullptr);
+    ASSERT_NE(b, nullptr);
+    EXPECT_EQ(alloc.small().stats().allocations, 1);
+
+    alloc.deallocate(b, 4096);
+    alloc.deallocate(a, 64);
+}
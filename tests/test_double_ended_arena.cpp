@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+#include "quanta/DoubleEndedArena.hpp"
+
+using namespace quanta;
+
+// CONSTRUCTION
+
+TEST(DoubleEndedArenaTest, Construction) {
+    DoubleEndedArena arena(1024);
+
+    EXPECT_EQ(arena.capacity(), 1024);
+    EXPECT_EQ(arena.used(), 0);
+    EXPECT_EQ(arena.available(), 1024);
+}
+
+// ALLOCATION FROM BOTH ENDS
+
+TEST(DoubleEndedArenaTest, EndsGrowTowardsEachOther) {
+    DoubleEndedArena arena(1024);
+
+    char* bottom = static_cast<char*>(arena.allocate_bottom(100, 1));
+    char* top = static_cast<char*>(arena.allocate_top(100, 1));
+    ASSERT_NE(bottom, nullptr);
+    ASSERT_NE(top, nullptr);
+
+    EXPECT_LT(bottom, top);
+    EXPECT_EQ(top - bottom, 1024 - 100);
+    EXPECT_EQ(arena.used_bottom(), 100);
+    EXPECT_EQ(arena.used_top(), 100);
+    EXPECT_EQ(arena.available(), 824);
+}
+
+TEST(DoubleEndedArenaTest, EndsCannotCross) {
+    DoubleEndedArena arena(256);
+
+    ASSERT_NE(arena.allocate_bottom(200, 1), nullptr);
+    EXPECT_EQ(arena.allocate_top(57, 1), nullptr);
+    ASSERT_NE(arena.allocate_top(56, 1), nullptr);
+    EXPECT_EQ(arena.available(), 0);
+    EXPECT_EQ(arena.allocate_bottom(1, 1), nullptr);
+}
+
+TEST(DoubleEndedArenaTest, Alignment) {
+    DoubleEndedArena arena(4096);
+
+    arena.allocate_bottom(1, 1);
+    arena.allocate_top(1, 1);
+
+    for (size_t align : {2, 4, 8, 16, 64, 256}) {
+        void* b = arena.allocate_bottom(3, align);
+        void* t = arena.allocate_top(3, align);
+        ASSERT_NE(b, nullptr);
+        ASSERT_NE(t, nullptr);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(b) % align, 0);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(t) % align, 0);
+    }
+}
+
+TEST(DoubleEndedArenaTest, TypedAllocation) {
+    DoubleEndedArena arena(1024);
+
+    double* d = arena.allocate_top<double>(4);
+    int* i = arena.allocate_bottom<int>(4);
+    ASSERT_NE(d, nullptr);
+    ASSERT_NE(i, nullptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(d) % alignof(double), 0);
+
+    for (int k = 0; k < 4; ++k) {
+        d[k] = k * 0.5;
+        i[k] = k;
+    }
+    EXPECT_EQ(d[3], 1.5);
+    EXPECT_EQ(i[3], 3);
+}
+
+// MARKERS
+
+TEST(DoubleEndedArenaTest, RewindEndsIndependently) {
+    DoubleEndedArena arena(1024);
+
+    arena.allocate_bottom(64, 1);
+    auto bottom = arena.bottom_marker();
+    arena.allocate_top(32, 1);
+    auto top = arena.top_marker();
+
+    arena.allocate_bottom(100, 1);
+    arena.allocate_top(200, 1);
+
+    arena.rewind_top(top);
+    EXPECT_EQ(arena.used_top(), 32);
+    EXPECT_EQ(arena.used_bottom(), 164);
+
+    arena.rewind_bottom(bottom);
+    EXPECT_EQ(arena.used_bottom(), 64);
+    EXPECT_EQ(arena.used_top(), 32);
+}
+
+TEST(DoubleEndedArenaTest, StaleMarkerIgnored) {
+    DoubleEndedArena arena(1024);
+
+    arena.allocate_bottom(64, 1);
+    auto bottom = arena.bottom_marker();
+    arena.reset_bottom();
+
+    arena.rewind_bottom(bottom);
+    EXPECT_EQ(arena.used_bottom(), 0);
+}
+
+TEST(DoubleEndedArenaTest, ResetOneEnd) {
+    DoubleEndedArena arena(1024);
+
+    arena.allocate_bottom(100, 1);
+    arena.allocate_top(100, 1);
+
+    arena.reset_top();
+    EXPECT_EQ(arena.used_top(), 0);
+    EXPECT_EQ(arena.used_bottom(), 100);
+
+    arena.reset();
+    EXPECT_EQ(arena.used(), 0);
+}
+
+// MOVE SEMANTICS
+
+TEST(DoubleEndedArenaTest, MoveConstruction) {
+    DoubleEndedArena arena1(1024);
+    arena1.allocate_bottom(10, 1);
+    arena1.allocate_top(20, 1);
+
+    DoubleEndedArena arena2(std::move(arena1));
+    EXPECT_EQ(arena2.used_bottom(), 10);
+    EXPECT_EQ(arena2.used_top(), 20);
+    EXPECT_EQ(arena1.capacity(), 0);
+    EXPECT_EQ(arena1.allocate_top(1, 1), nullptr);
+}
@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+#include "quanta/FrameArena.hpp"
+
+using namespace quanta;
+
+// CONSTRUCTION
+
+TEST(FrameArenaTest, Construction) {
+    FrameArena<3> frames(1024);
+
+    EXPECT_EQ(frames.capacity(), 1024);
+    EXPECT_EQ(frames.used(), 0);
+    EXPECT_EQ(frames.frame_index(), 0);
+    EXPECT_EQ(FrameArena<3>::frames_in_flight(), 3);
+}
+
+// FRAME ROTATION
+
+TEST(FrameArenaTest, DataSurvivesNMinusOneFrames) {
+    FrameArena<3> frames(1024);
+
+    int* value = frames.allocate<int>();
+    ASSERT_NE(value, nullptr);
+    *value = 42;
+
+    frames.begin_frame();
+    frames.allocate<int>(16);
+    frames.begin_frame();
+    frames.allocate<int>(16);
+
+    // Still owned by a live frame: frame 0 is reclaimed only by frame 3
+    EXPECT_TRUE(frames.owns(value));
+    EXPECT_EQ(*value, 42);
+    EXPECT_EQ(frames.previous(2).used(), sizeof(int));
+
+    Arena& reused = frames.begin_frame();
+    EXPECT_TRUE(reused.owns(value));
+    EXPECT_EQ(reused.used(), 0);
+}
+
+TEST(FrameArenaTest, BeginFrameResetsOnlyOldest) {
+    FrameArena<2> frames(1024);
+
+    frames.allocate(100, 1);
+    frames.begin_frame();
+    frames.allocate(50, 1);
+
+    EXPECT_EQ(frames.used(), 50);
+    EXPECT_EQ(frames.previous(1).used(), 100);
+    EXPECT_EQ(frames.total_used(), 150);
+
+    frames.begin_frame();
+    EXPECT_EQ(frames.used(), 0);
+    EXPECT_EQ(frames.previous(1).used(), 50);
+    EXPECT_EQ(frames.frame_index(), 2);
+}
+
+TEST(FrameArenaTest, FramesUseDistinctArenas) {
+    FrameArena<2> frames(256);
+
+    void* a = frames.allocate(8, 8);
+    frames.begin_frame();
+    void* b = frames.allocate(8, 8);
+
+    EXPECT_FALSE(frames.current().owns(a));
+    EXPECT_TRUE(frames.current().owns(b));
+}
+
+TEST(FrameArenaTest, SingleFrame) {
+    FrameArena<1> frames(256);
+
+    frames.allocate(64, 1);
+    frames.begin_frame();
+    EXPECT_EQ(frames.used(), 0);
+}
+
+TEST(FrameArenaTest, PerFrameCapacity) {
+    FrameArena<2> frames(128);
+
+    EXPECT_NE(frames.allocate(128, 1), nullptr);
+    EXPECT_EQ(frames.allocate(1, 1), nullptr);
+
+    frames.begin_frame();
+    EXPECT_NE(frames.allocate(128, 1), nullptr);
+}
+
+// RESET AND MOVE
+
+TEST(FrameArenaTest, ResetAllFrames) {
+    FrameArena<2> frames(256);
+
+    frames.allocate(10, 1);
+    frames.begin_frame();
+    frames.allocate(20, 1);
+
+    frames.reset();
+    EXPECT_EQ(frames.total_used(), 0);
+}
+
+TEST(FrameArenaTest, MoveConstruction) {
+    FrameArena<2> frames1(256);
+    frames1.allocate(10, 1);
+
+    FrameArena<2> frames2(std::move(frames1));
+    EXPECT_EQ(frames2.used(), 10);
+    EXPECT_EQ(frames2.capacity(), 256);
+}
@@ -0,0 +1,271 @@
+#include <gtest/gtest.h>
+#include "quanta/GrowingArena.hpp"
+
+using namespace quanta;
+
+// CAPACITY ESTIMATOR
+
+TEST(CapacityEstimatorTest, EmptyEstimateIsZero) {
+    CapacityEstimator estimator;
+    EXPECT_EQ(estimator.estimate(), 0);
+}
+
+TEST(CapacityEstimatorTest, SteadyPeaks) {
+    CapacityEstimator estimator;
+    for (int i = 0; i < 10; ++i)
+        estimator.record(5000);
+
+    EXPECT_EQ(estimator.estimate(), 5000);
+}
+
+TEST(CapacityEstimatorTest, PercentileIgnoresRareSpike) {
+    CapacityEstimator estimator(0.5, 1.0);
+    for (int i = 0; i < 9; ++i)
+        estimator.record(1000);
+    estimator.record(1000000);
+
+    EXPECT_EQ(estimator.estimate(), 1000);
+}
+
+TEST(CapacityEstimatorTest, DecayFollowsRecentTraffic) {
+    CapacityEstimator estimator(0.9, 0.5);
+    for (int i = 0; i < 20; ++i)
+        estimator.record(100000);
+    for (int i = 0; i < 6; ++i)
+        estimator.record(2000);
+
+    EXPECT_EQ(estimator.estimate(), 2000);
+}
+
+TEST(CapacityEstimatorTest, HistoryIsBounded) {
+    CapacityEstimator estimator;
+    for (size_t i = 0; i < 2 * CapacityEstimator::history; ++i)
+        estimator.record(i);
+
+    EXPECT_EQ(estimator.samples(), CapacityEstimator::history);
+}
+
+// CHAINING
+
+TEST(GrowingArenaTest, FirstBlockIsLazy) {
+    GrowingArena arena(4096);
+
+    EXPECT_EQ(arena.block_count(), 0);
+    EXPECT_EQ(arena.capacity(), 0);
+
+    ASSERT_NE(arena.allocate(10, 1), nullptr);
+    EXPECT_EQ(arena.block_count(), 1);
+    EXPECT_EQ(arena.capacity(), 4096);
+}
+
+TEST(GrowingArenaTest, ChainsWhenExhausted) {
+    GrowingArena arena(1024);
+    arena.set_large_threshold(SIZE_MAX);
+
+    void* a = arena.allocate(800, 1);
+    void* b = arena.allocate(800, 1);
+    ASSERT_NE(a, nullptr);
+    ASSERT_NE(b, nullptr);
+
+    EXPECT_EQ(arena.block_count(), 2);
+    EXPECT_EQ(arena.used(), 1600);
+    EXPECT_TRUE(arena.owns(a));
+    EXPECT_TRUE(arena.owns(b));
+}
+
+TEST(GrowingArenaTest, OversizedRequestGetsOwnBlock) {
+    GrowingArena arena(1024);
+    arena.set_large_threshold(SIZE_MAX);
+
+    ASSERT_NE(arena.allocate(10000, 64), nullptr);
+    EXPECT_GE(arena.capacity(), 10000);
+}
+
+TEST(GrowingArenaTest, Alignment) {
+    GrowingArena arena(1024);
+
+    arena.allocate(1, 1);
+    for (size_t align : {2, 8, 64, 512}) {
+        void* p = arena.allocate(3, align);
+        ASSERT_NE(p, nullptr);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % align, 0);
+    }
+}
+
+TEST(GrowingArenaTest, InvalidRequests) {
+    GrowingArena arena(1024);
+
+    EXPECT_EQ(arena.allocate(0, 8), nullptr);
+    EXPECT_EQ(arena.allocate(8, 3), nullptr);
+}
+
+// RESET
+
+TEST(GrowingArenaTest, FixedResetKeepsFirstBlock) {
+    GrowingArena arena(1024);
+    arena.set_large_threshold(SIZE_MAX);
+
+    arena.allocate(800, 1);
+    arena.allocate(800, 1);
+    arena.allocate(800, 1);
+    arena.reset();
+
+    EXPECT_EQ(arena.block_count(), 1);
+    EXPECT_EQ(arena.capacity(), 1024);
+    EXPECT_EQ(arena.used(), 0);
+    EXPECT_EQ(arena.block_size(), 1024);
+}
+
+TEST(GrowingArenaTest, AdaptiveConvergesToSingleBlock) {
+    GrowingArena arena(1024, GrowingArena::Sizing::Adaptive);
+
+    for (int cycle = 0; cycle < 5; ++cycle) {
+        for (int i = 0; i < 100; ++i)
+            arena.allocate(100, 1);
+        arena.reset();
+    }
+
+    // 10 000 bytes per cycle now fit in one block
+    EXPECT_GE(arena.block_size(), 10000);
+    for (int i = 0; i < 100; ++i)
+        arena.allocate(100, 1);
+    EXPECT_EQ(arena.block_count(), 1);
+}
+
+TEST(GrowingArenaTest, AdaptiveShrinksAfterTrafficDrops) {
+    GrowingArena arena(1024, GrowingArena::Sizing::Adaptive, CapacityEstimator(0.9, 0.5));
+
+    for (int cycle = 0; cycle < 5; ++cycle) {
+        for (int i = 0; i < 1024; ++i)
+            arena.allocate(1024, 1);
+        arena.reset();
+    }
+    EXPECT_GE(arena.capacity(), size_t{1} << 20);
+
+    for (int cycle = 0; cycle < 10; ++cycle) {
+        arena.allocate(1000, 1);
+        arena.reset();
+    }
+    EXPECT_LE(arena.block_size(), 4096);
+    EXPECT_LE(arena.capacity(), 2 * 4096);
+}
+
+TEST(GrowingArenaTest, ReleaseFreesEverything) {
+    GrowingArena arena(1024);
+
+    arena.allocate(100, 1);
+    arena.release();
+    EXPECT_EQ(arena.block_count(), 0);
+    EXPECT_EQ(arena.capacity(), 0);
+}
+
+// LARGE ALLOCATION BYPASS
+
+TEST(GrowingArenaTest, LargeRequestBypassesBlocks) {
+    GrowingArena arena(1 << 20);
+
+    arena.allocate(100, 8);
+    size_t available = arena.available();
+
+    void* big = arena.allocate(3 << 20, 64);
+    ASSERT_NE(big, nullptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(big) % 64, 0);
+    EXPECT_TRUE(arena.owns(big));
+
+    // Current block is untouched: no tail waste, no new block
+    EXPECT_EQ(arena.block_count(), 1);
+    EXPECT_EQ(arena.available(), available);
+    EXPECT_EQ(arena.large_count(), 1);
+    EXPECT_EQ(arena.used(), 100 + (3 << 20));
+
+    static_cast<char*>(big)[(3 << 20) - 1] = 1;
+}
+
+TEST(GrowingArenaTest, DefaultThresholdIsQuarterBlock) {
+    GrowingArena arena(1 << 20);
+    EXPECT_EQ(arena.large_threshold(), 256 << 10);
+
+    arena.allocate(256 << 10, 1);
+    EXPECT_EQ(arena.large_count(), 0);
+    arena.allocate((256 << 10) + 1, 1);
+    EXPECT_EQ(arena.large_count(), 1);
+}
+
+TEST(GrowingArenaTest, DefaultThresholdHasFloor) {
+    GrowingArena arena(4096);
+    EXPECT_EQ(arena.large_threshold(), GrowingArena::min_large_size);
+}
+
+TEST(GrowingArenaTest, MediumRequestsStayInBlocksWhenAdaptive) {
+    GrowingArena arena(4096, GrowingArena::Sizing::Adaptive);
+
+    // Medium requests on a small block chain blocks rather than mapping each one
+    for (int cycle = 0; cycle < 5; ++cycle) {
+        for (int i = 0; i < 8; ++i)
+            ASSERT_NE(arena.allocate(2048, 8), nullptr);
+        EXPECT_EQ(arena.large_count(), 0);
+        arena.reset();
+    }
+
+    // ...which the estimator sees, so the block grows to fit the cycle
+    EXPECT_GE(arena.block_size(), 8 * 2048);
+}
+
+TEST(GrowingArenaTest, ResetUnmapsLargeBlocks) {
+    GrowingArena arena(4096);
+
+    void* big = arena.allocate(100000, 8);
+    arena.allocate(100000, 8);
+    EXPECT_EQ(arena.large_count(), 2);
+
+    arena.reset();
+    EXPECT_EQ(arena.large_count(), 0);
+    EXPECT_EQ(arena.used(), 0);
+    EXPECT_FALSE(arena.owns(big));
+}
+
+TEST(GrowingArenaTest, LargeBlocksIgnoredByEstimator) {
+    GrowingArena arena(8192, GrowingArena::Sizing::Adaptive);
+
+    for (int cycle = 0; cycle < 5; ++cycle) {
+        arena.allocate(1000, 8);
+        arena.allocate(1 << 20, 8);
+        arena.reset();
+    }
+    EXPECT_EQ(arena.block_size(), 4096);
+}
+
+TEST(GrowingArenaTest, LargeOverAlignment) {
+    GrowingArena arena(4096);
+
+    void* p = arena.allocate(100000, 1 << 16);
+    ASSERT_NE(p, nullptr);
+    EXPECT_EQ(arena.large_count(), 1);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % (1 << 16), 0);
+    static_cast<char*>(p)[99999] = 1;
+}
+
+TEST(GrowingArenaTest, ExplicitThreshold) {
+    GrowingArena arena(4096);
+    arena.set_large_threshold(SIZE_MAX);
+
+    arena.allocate(100000, 8);
+    EXPECT_EQ(arena.large_count(), 0);
+    EXPECT_EQ(arena.block_count(), 1);
+
+    arena.set_large_threshold(0);
+    EXPECT_EQ(arena.large_threshold(), GrowingArena::min_large_size);
+}
+
+// MOVE SEMANTICS
+
+TEST(GrowingArenaTest, MoveConstruction) {
+    GrowingArena arena1(1024);
+    void* p = arena1.allocate(100, 1);
+
+    GrowingArena arena2(std::move(arena1));
+    EXPECT_TRUE(arena2.owns(p));
+    EXPECT_EQ(arena2.used(), 100);
+    EXPECT_EQ(arena1.block_count(), 0);
+    EXPECT_FALSE(arena1.owns(p));
+}
@@ -0,0 +1,272 @@
+#include <gtest/gtest.h>
+#include "quanta/Arena.hpp"
+#include "quanta/HeapProfiler.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace quanta;
+
+namespace {
+
+// Makes operator new throw while set, to exercise out-of-memory paths
+std::atomic<bool> fail_allocations{false};
+
+} // namespace
+
+// Replacement pair over malloc/free; GCC flags the pairing once both are inlined
+#if defined(__GNUC__) && !defined(__clang__)
+    #pragma GCC diagnostic push
+    #pragma GCC diagnostic ignored "-Wpragmas"
+    #pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(std::size_t size) {
+    if (fail_allocations.load(std::memory_order_relaxed))
+        throw std::bad_alloc();
+    if (void* p = std::malloc(size != 0 ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+    #pragma GCC diagnostic pop
+#endif
+
+namespace {
+
+// Walks the top-level fields of a protocol buffer message
+struct ProtoReader {
+    const std::string& data;
+    size_t pos = 0;
+
+    uint64_t varint() {
+        uint64_t value = 0;
+        for (int shift = 0; pos < data.size(); shift += 7) {
+            uint8_t byte = static_cast<uint8_t>(data[pos++]);
+            value |= uint64_t{byte & 0x7Fu} << shift;
+            if ((byte & 0x80) == 0)
+                break;
+        }
+        return value;
+    }
+
+    // Returns false at the end; bytes receives length-delimited payloads
+    bool next(uint32_t& field, std::string& bytes) {
+        if (pos >= data.size())
+            return false;
+        uint64_t tag = varint();
+        field = static_cast<uint32_t>(tag >> 3);
+        if ((tag & 7) == 2) {
+            size_t length = static_cast<size_t>(varint());
+            bytes = data.substr(pos, length);
+            pos += length;
+        } else {
+            bytes.clear();
+            varint();
+        }
+        return true;
+    }
+};
+
+} // namespace
+
+// SAMPLING
+
+TEST(HeapProfilerTest, IntervalOneSamplesEverything) {
+    HeapProfiler profiler(1);
+    for (int i = 0; i < 100; ++i)
+        profiler.record(64);
+
+    EXPECT_EQ(profiler.samples(), 100u);
+    EXPECT_EQ(profiler.estimated_bytes(), 6400u);
+    EXPECT_GE(profiler.stack_count(), 1u);
+}
+
+TEST(HeapProfilerTest, SparseSamplingEstimatesVolume) {
+    HeapProfiler profiler(4096);
+    constexpr size_t count = 200000;
+    for (size_t i = 0; i < count; ++i)
+        profiler.record(64);
+
+    // ~3125 samples expected; the estimate should be well within 10%
+    double actual = static_cast<double>(count * 64);
+    double estimate = static_cast<double>(profiler.estimated_bytes());
+    EXPECT_GT(profiler.samples(), 2500u);
+    EXPECT_LT(profiler.samples(), 3800u);
+    EXPECT_NEAR(estimate / actual, 1.0, 0.1);
+}
+
+TEST(HeapProfilerTest, SparseSamplingEstimatesObjectCount) {
+    HeapProfiler profiler(4096);
+    constexpr size_t count = 100000;
+    for (size_t i = 0; i < count; ++i) {
+        profiler.record(32);
+        profiler.record(3000);
+    }
+
+    // Each sample counts as 1/p objects, not one, so small objects are not under-counted
+    double estimate = static_cast<double>(profiler.estimated_objects());
+    EXPECT_NEAR(estimate / (2.0 * count), 1.0, 0.1);
+    EXPECT_NEAR(static_cast<double>(profiler.estimated_bytes()) / (count * 3032.0), 1.0, 0.1);
+}
+
+TEST(HeapProfilerTest, LargeAllocationsAlwaysSampled) {
+    HeapProfiler profiler(1 << 20);
+    profiler.record(8 << 20);
+    EXPECT_EQ(profiler.samples(), 1u);
+    EXPECT_EQ(profiler.estimated_objects(), 1u);
+
+    // Sampled with probability 1 - e^-8, so weighted only slightly above its size
+    double estimate = static_cast<double>(profiler.estimated_bytes());
+    EXPECT_NEAR(estimate / static_cast<double>(8 << 20), 1.0, 0.001);
+}
+
+TEST(HeapProfilerTest, SampleDroppedWhenOutOfMemory) {
+    HeapProfiler profiler(1);
+
+    // A new stack needs a map node; the allocation being recorded must not be failed
+    fail_allocations = true;
+    profiler.record(64);
+    fail_allocations = false;
+
+    EXPECT_EQ(profiler.samples(), 0u);
+    EXPECT_EQ(profiler.dropped(), 1u);
+    EXPECT_EQ(profiler.stack_count(), 0u);
+
+    profiler.record(64);
+    EXPECT_EQ(profiler.samples(), 1u);
+    EXPECT_EQ(profiler.dropped(), 1u);
+}
+
+TEST(HeapProfilerTest, Clear) {
+    HeapProfiler profiler(1);
+    profiler.record(10);
+    profiler.clear();
+    EXPECT_EQ(profiler.samples(), 0u);
+    EXPECT_EQ(profiler.stack_count(), 0u);
+}
+
+TEST(HeapProfilerTest, ConcurrentRecording) {
+    HeapProfiler profiler(1);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&profiler] {
+            for (int i = 0; i < 1000; ++i)
+                profiler.record(16);
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    EXPECT_EQ(profiler.samples(), 4000u);
+    EXPECT_EQ(profiler.estimated_bytes(), 64000u);
+}
+
+TEST(HeapProfilerTest, ConcurrentSparseSamplingIsNotInflated) {
+    HeapProfiler profiler(4096);
+    constexpr size_t per_thread = 100000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&profiler] {
+            for (size_t i = 0; i < per_thread; ++i)
+                profiler.record(64);
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    // Threads that run past the sampling point together must not each take a sample
+    double actual = static_cast<double>(4 * per_thread * 64);
+    EXPECT_LT(profiler.samples(), 4 * per_thread * 64 / 4096 * 12 / 10);
+    EXPECT_NEAR(static_cast<double>(profiler.estimated_bytes()) / actual, 1.0, 0.1);
+}
+
+TEST(HeapProfilerTest, ProfilingAllocatorWrapsArena) {
+    HeapProfiler profiler(1);
+    ProfilingAllocator<Arena> arena(Arena(4096), profiler);
+
+    EXPECT_NE(arena.allocate(100, 8), nullptr);
+    EXPECT_EQ(arena.allocate(8192, 8), nullptr);     // failures are not recorded
+    arena.reset();
+
+    EXPECT_EQ(profiler.samples(), 1u);
+    EXPECT_EQ(arena.parent().used(), 0u);
+}
+
+// PPROF EXPORT
+
+TEST(HeapProfilerTest, EncodesPprofProfile) {
+    HeapProfiler profiler(1);
+    for (int i = 0; i < 10; ++i)
+        profiler.record(32);
+
+    std::string profile = profiler.encode_pprof();
+    ProtoReader reader{profile};
+
+    uint32_t field;
+    std::string bytes;
+    int sample_types = 0, samples = 0, locations = 0;
+    std::vector<std::string> strings;
+    uint64_t total_objects = 0;
+    while (reader.next(field, bytes)) {
+        if (field == 1) {
+            ++sample_types;
+        } else if (field == 2) {
+            ++samples;
+            // Sample.value is packed: objects then bytes
+            ProtoReader sample{bytes};
+            uint32_t f;
+            std::string payload;
+            while (sample.next(f, payload)) {
+                if (f == 2) {
+                    ProtoReader values{payload};
+                    total_objects += values.varint();
+                }
+            }
+        } else if (field == 4) {
+            ++locations;
+        } else if (field == 6) {
+            strings.push_back(bytes);
+        }
+    }
+
+    EXPECT_EQ(sample_types, 2);
+    EXPECT_GE(samples, 1);
+    EXPECT_GE(locations, 1);
+    EXPECT_EQ(total_objects, 10u);
+    ASSERT_FALSE(strings.empty());
+    EXPECT_EQ(strings[0], "");
+    EXPECT_NE(std::find(strings.begin(), strings.end(), "alloc_space"), strings.end());
+    EXPECT_NE(std::find(strings.begin(), strings.end(), "bytes"), strings.end());
+}
+
+TEST(HeapProfilerTest, WritesProfileFile) {
+    HeapProfiler profiler(1);
+    profiler.record(128);
+
+    std::string path = testing::TempDir() + "arenax_heap_" + std::to_string(std::rand()) + ".pb";
+    ASSERT_TRUE(profiler.write_pprof(path.c_str()));
+
+    std::ifstream in(path, std::ios::binary);
+    std::string contents((std::istreambuf_iterator<char>(in)), {});
+    ASSERT_FALSE(contents.empty());
+    EXPECT_EQ(contents[0], '\x0a');    // Profile.sample_type, length-delimited
+
+    std::remove(path.c_str());
+}
@@ -0,0 +1,231 @@
+#include <gtest/gtest.h>
+#include "quanta/Arena.hpp"
+#include "quanta/OffsetPtr.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+using namespace quanta;
+
+namespace {
+
+struct Node {
+    int value;
+    offset_ptr<Node> next;
+};
+
+// Build a list 0 -> 1 -> ... -> count-1 in the arena, returning the head
+Node* build_list(Arena& arena, int count) {
+    Node* head = nullptr;
+    for (int i = count - 1; i >= 0; --i) {
+        Node* node = arena.allocate<Node>();
+        new (node) Node{i, head};
+        head = node;
+    }
+    return head;
+}
+
+int sum_list(const Node* node) {
+    int sum = 0;
+    for (; node != nullptr; node = node->next.get())
+        sum += node->value;
+    return sum;
+}
+
+} // namespace
+
+// BASICS
+
+TEST(OffsetPtrTest, DefaultIsNull) {
+    offset_ptr<int> p;
+    EXPECT_FALSE(p);
+    EXPECT_EQ(p.get(), nullptr);
+    EXPECT_TRUE(p == nullptr);
+}
+
+TEST(OffsetPtrTest, PointsToTarget) {
+    int values[4] = {1, 2, 3, 4};
+    offset_ptr<int> p = &values[1];
+
+    EXPECT_TRUE(p);
+    EXPECT_EQ(p.get(), &values[1]);
+    EXPECT_EQ(*p, 2);
+    EXPECT_EQ(p[2], 4);
+
+    p = nullptr;
+    EXPECT_FALSE(p);
+}
+
+TEST(OffsetPtrTest, CanPointToItself) {
+    struct Self {
+        offset_ptr<Self> self;
+    } s;
+    s.self = &s;
+    EXPECT_EQ(s.self.get(), &s);
+}
+
+TEST(OffsetPtrTest, CopyKeepsTarget) {
+    int value = 7;
+    offset_ptr<int> a = &value;
+    offset_ptr<int> b;
+    b = a;
+    offset_ptr<int> c(b);
+
+    EXPECT_EQ(b.get(), &value);
+    EXPECT_EQ(c.get(), &value);
+    EXPECT_TRUE(a == c);
+}
+
+TEST(OffsetPtrTest, ConvertsToBase) {
+    struct Base { int x = 1; };
+    struct Derived : Base { int y = 2; };
+
+    Derived d;
+    offset_ptr<Derived> pd = &d;
+    offset_ptr<Base> pb = pd;
+    EXPECT_EQ(pb->x, 1);
+}
+
+// RELOCATION
+
+TEST(OffsetPtrTest, SurvivesMemcpy) {
+    Arena arena(4096);
+    Node* head = build_list(arena, 10);
+    size_t offset = static_cast<size_t>(reinterpret_cast<char*>(head) - arena.data());
+
+    Arena copy(4096);
+    char* dst = static_cast<char*>(copy.allocate(arena.used(), alignof(std::max_align_t)));
+    ASSERT_NE(dst, nullptr);
+    std::memcpy(dst, arena.data(), arena.used());
+    std::memset(arena.data(), 0, arena.used());
+
+    EXPECT_EQ(sum_list(reinterpret_cast<Node*>(dst + offset)), 45);
+}
+
+#if !defined(_WIN32)
+TEST(OffsetPtrTest, SurvivesSnapshotRoundTrip) {
+    std::string path = testing::TempDir() + "offset_ptr_snapshot_" + std::to_string(std::rand()) + ".bin";
+
+    size_t offset = 0;
+    {
+        Arena arena(1 << 16);
+        Node* head = build_list(arena, 1000);
+        offset = static_cast<size_t>(reinterpret_cast<char*>(head) - arena.data());
+        ASSERT_TRUE(arena.save(path.c_str()));
+    }
+
+    Arena restored = Arena::load(path.c_str());
+    ASSERT_NE(restored.data(), nullptr);
+    Node* head = reinterpret_cast<Node*>(restored.data() + offset);
+    EXPECT_EQ(sum_list(head), 999 * 1000 / 2);
+
+    // The restored copy is private and can be extended
+    Node* extra = restored.allocate<Node>();
+    ASSERT_NE(extra, nullptr);
+    new (extra) Node{1000, head};
+    EXPECT_EQ(sum_list(extra), 1000 * 1001 / 2);
+
+    std::remove(path.c_str());
+}
+#endif
+
+// 32-BIT ARENA POINTERS
+
+namespace {
+
+struct TreeNode {
+    int key;
+    arena_ptr32<TreeNode> left;
+    arena_ptr32<TreeNode> right;
+};
+
+void insert(Arena& arena, arena_ptr32<TreeNode>& root, int key) {
+    arena_ptr32<TreeNode>* link = &root;
+    while (TreeNode* node = link->get(arena))
+        link = key < node->key ? &node->left : &node->right;
+
+    TreeNode* node = arena.allocate<TreeNode>();
+    new (node) TreeNode{key, nullptr, nullptr};
+    *link = arena_ptr32<TreeNode>::from(arena, node);
+}
+
+bool contains(const Arena& arena, arena_ptr32<TreeNode> root, int key) {
+    while (TreeNode* node = root.get(arena)) {
+        if (node->key == key)
+            return true;
+        root = key < node->key ? node->left : node->right;
+    }
+    return false;
+}
+
+} // namespace
+
+TEST(ArenaPtr32Test, IsFourBytes) {
+    EXPECT_EQ(sizeof(arena_ptr32<TreeNode>), 4);
+    EXPECT_EQ(sizeof(TreeNode), 12);
+}
+
+TEST(ArenaPtr32Test, DefaultIsNull) {
+    Arena arena(64);
+    arena_ptr32<int> p;
+    EXPECT_FALSE(p);
+    EXPECT_TRUE(p == nullptr);
+    EXPECT_EQ(p.get(arena), nullptr);
+}
+
+TEST(ArenaPtr32Test, EncodesOffsetFromBase) {
+    Arena arena(1024);
+    arena.allocate(100, 1);
+    int* value = arena.allocate<int>();
+    *value = 42;
+
+    auto p = arena_ptr32<int>::from(arena, value);
+    EXPECT_TRUE(p);
+    EXPECT_EQ(p.offset(), static_cast<uint32_t>(reinterpret_cast<char*>(value) - arena.data()));
+    EXPECT_EQ(p.get(arena), value);
+    EXPECT_EQ(*p.get(arena.data()), 42);
+}
+
+TEST(ArenaPtr32Test, FirstAllocationIsNotNull) {
+    Arena arena(64);
+    int* value = arena.allocate<int>();
+    auto p = arena_ptr32<int>::from(arena, value);
+    EXPECT_EQ(p.offset(), 0u);
+    EXPECT_TRUE(p);
+}
+
+TEST(ArenaPtr32Test, OutOfRangeIsNull) {
+    Arena arena(64);
+    int* value = arena.allocate<int>();
+
+    EXPECT_FALSE(arena_ptr32<int>::from(arena, nullptr));
+    // Pointers below the base cannot be encoded
+    EXPECT_FALSE(arena_ptr32<int>::from(arena.data() + 32, value));
+}
+
+TEST(ArenaPtr32Test, BuildsTree) {
+    Arena arena(1 << 16);
+    arena_ptr32<TreeNode> root;
+    for (int key : {50, 20, 80, 10, 30, 70, 90, 25})
+        insert(arena, root, key);
+
+    for (int key : {50, 20, 80, 10, 30, 70, 90, 25})
+        EXPECT_TRUE(contains(arena, root, key));
+    EXPECT_FALSE(contains(arena, root, 60));
+}
+
+TEST(ArenaPtr32Test, SurvivesMemcpy) {
+    Arena arena(1 << 16);
+    arena_ptr32<TreeNode> root;
+    for (int key = 0; key < 100; ++key)
+        insert(arena, root, (key * 37) % 100);
+
+    Arena copy(1 << 16);
+    char* dst = static_cast<char*>(copy.allocate(arena.used(), 1));
+    ASSERT_EQ(dst, copy.data());
+    std::memcpy(dst, arena.data(), arena.used());
+
+    for (int key = 0; key < 100; ++key)
+        EXPECT_TRUE(contains(copy, root, key));
+}
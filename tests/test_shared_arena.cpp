@@ -0,0 +1,217 @@
+#include <gtest/gtest.h>
+#include "quanta/SharedArena.hpp"
+
+#include <cstring>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace quanta;
+
+namespace {
+
+std::string unique_name() {
+    return "/quanta_test_" + std::to_string(getpid()) + "_" + std::to_string(std::rand());
+}
+
+struct Message {
+    uint32_t length;
+    char text[60];
+};
+
+} // namespace
+
+// CREATION
+
+TEST(SharedArenaTest, CreateAnonymous) {
+    SharedArena arena = SharedArena::create_anonymous(1 << 16);
+    ASSERT_TRUE(arena);
+    EXPECT_GE(arena.fd(), 0);
+    EXPECT_GE(arena.capacity(), (1 << 16) - 64);
+    EXPECT_EQ(arena.used(), 0);
+    EXPECT_FALSE(arena.root());
+}
+
+TEST(SharedArenaTest, DetachedArenaFails) {
+    SharedArena arena;
+    EXPECT_FALSE(arena);
+    EXPECT_EQ(arena.allocate(16), nullptr);
+    EXPECT_EQ(arena.capacity(), 0);
+    EXPECT_EQ(arena.get(SharedArena::Handle{64}), nullptr);
+}
+
+TEST(SharedArenaTest, OpenMissing) {
+    SharedArena arena = SharedArena::open("/quanta_test_does_not_exist");
+    EXPECT_FALSE(arena);
+}
+
+TEST(SharedArenaTest, CreateExistingNameFails) {
+    std::string name = unique_name();
+    SharedArena first = SharedArena::create(name.c_str(), 4096);
+    ASSERT_TRUE(first);
+
+    SharedArena second = SharedArena::create(name.c_str(), 4096);
+    EXPECT_FALSE(second);
+
+    EXPECT_TRUE(SharedArena::unlink(name.c_str()));
+}
+
+// ALLOCATION
+
+TEST(SharedArenaTest, AllocateAligned) {
+    SharedArena arena = SharedArena::create_anonymous(4096);
+    ASSERT_TRUE(arena);
+
+    void* a = arena.allocate(3, 1);
+    void* b = arena.allocate(8, 64);
+    ASSERT_NE(a, nullptr);
+    ASSERT_NE(b, nullptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(b) % 64, 0u);
+    EXPECT_TRUE(arena.owns(a));
+    EXPECT_TRUE(arena.owns(b));
+}
+
+TEST(SharedArenaTest, ExhaustionReturnsNull) {
+    SharedArena arena = SharedArena::create_anonymous(4096);
+    ASSERT_TRUE(arena);
+
+    EXPECT_NE(arena.allocate(arena.capacity(), 1), nullptr);
+    EXPECT_EQ(arena.allocate(1, 1), nullptr);
+    EXPECT_EQ(arena.available(), 0);
+
+    arena.reset();
+    EXPECT_EQ(arena.used(), 0);
+    EXPECT_NE(arena.allocate(1, 1), nullptr);
+}
+
+TEST(SharedArenaTest, HandlesRoundTrip) {
+    SharedArena arena = SharedArena::create_anonymous(4096);
+    int* value = arena.allocate<int>();
+    ASSERT_NE(value, nullptr);
+
+    SharedArena::Handle h = arena.handle(value);
+    EXPECT_TRUE(h);
+    EXPECT_EQ(arena.get<int>(h), value);
+
+    int local = 0;
+    EXPECT_FALSE(arena.handle(&local));
+    EXPECT_EQ(arena.get(SharedArena::Handle{}), nullptr);
+}
+
+TEST(SharedArenaTest, ConcurrentAllocationsAreDisjoint) {
+    SharedArena arena = SharedArena::create_anonymous(1 << 20);
+    ASSERT_TRUE(arena);
+
+    constexpr int thread_count = 4;
+    constexpr int per_thread = 1000;
+    std::vector<std::vector<uint64_t>> results(thread_count);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < thread_count; ++t) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < per_thread; ++i) {
+                void* p = arena.allocate(32, 16);
+                if (p != nullptr)
+                    results[t].push_back(arena.handle(p).offset);
+            }
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    std::set<uint64_t> offsets;
+    for (const auto& r : results) {
+        EXPECT_EQ(r.size(), per_thread);
+        offsets.insert(r.begin(), r.end());
+    }
+    EXPECT_EQ(offsets.size(), size_t{thread_count * per_thread});
+    EXPECT_EQ(arena.used(), size_t{thread_count * per_thread * 32});
+}
+
+// SHARING
+
+TEST(SharedArenaTest, NamedArenaSeenByEveryMapping) {
+    std::string name = unique_name();
+    SharedArena producer = SharedArena::create(name.c_str(), 1 << 16);
+    ASSERT_TRUE(producer);
+    SharedArena consumer = SharedArena::open(name.c_str());
+    ASSERT_TRUE(consumer);
+    EXPECT_TRUE(SharedArena::unlink(name.c_str()));
+
+    Message* msg = producer.allocate<Message>();
+    ASSERT_NE(msg, nullptr);
+    msg->length = 5;
+    std::memcpy(msg->text, "hello", 5);
+    producer.set_root(producer.handle(msg));
+
+    // Different address, same bytes
+    Message* seen = consumer.get<Message>(consumer.root());
+    ASSERT_NE(seen, nullptr);
+    EXPECT_NE(static_cast<void*>(seen), static_cast<void*>(msg));
+    EXPECT_EQ(std::string(seen->text, seen->length), "hello");
+
+    // Both mappings share the bump pointer
+    void* next = consumer.allocate(16);
+    ASSERT_NE(next, nullptr);
+    EXPECT_EQ(producer.used(), consumer.used());
+    EXPECT_GT(consumer.handle(next).offset, producer.root().offset);
+}
+
+TEST(SharedArenaTest, OpenByDescriptor) {
+    SharedArena arena = SharedArena::create_anonymous(4096);
+    int* value = arena.allocate<int>();
+    *value = 1234;
+
+    SharedArena other = SharedArena::open_fd(arena.fd());
+    ASSERT_TRUE(other);
+    EXPECT_EQ(*other.get<int>(arena.handle(value)), 1234);
+}
+
+TEST(SharedArenaTest, ChildProcessWritesParentReads) {
+    SharedArena arena = SharedArena::create_anonymous(1 << 16);
+    ASSERT_TRUE(arena);
+
+    pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+        // Child: attach through the inherited descriptor and publish a message
+        SharedArena child = SharedArena::open_fd(arena.fd());
+        Message* msg = child.allocate<Message>();
+        if (msg == nullptr)
+            _exit(1);
+        msg->length = 10;
+        std::memcpy(msg->text, "from child", 10);
+        child.set_root(child.handle(msg));
+        _exit(0);
+    }
+
+    int status = 0;
+    ASSERT_EQ(waitpid(pid, &status, 0), pid);
+    ASSERT_TRUE(WIFEXITED(status));
+    ASSERT_EQ(WEXITSTATUS(status), 0);
+
+    Message* msg = arena.get<Message>(arena.root());
+    ASSERT_NE(msg, nullptr);
+    EXPECT_EQ(std::string(msg->text, msg->length), "from child");
+}
+
+TEST(SharedArenaTest, MoveTransfersMapping) {
+    SharedArena a = SharedArena::create_anonymous(4096);
+    ASSERT_TRUE(a);
+    int fd = a.fd();
+
+    SharedArena b(std::move(a));
+    EXPECT_FALSE(a);
+    EXPECT_TRUE(b);
+    EXPECT_EQ(b.fd(), fd);
+
+    SharedArena c;
+    c = std::move(b);
+    EXPECT_TRUE(c);
+    EXPECT_NE(c.allocate(8), nullptr);
+}
+#endif
@@ -0,0 +1,350 @@
+#include <gtest/gtest.h>
+#include "quanta/SharedPool.hpp"
+
+#include <atomic>
+#include <cstring>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace quanta;
+
+namespace {
+
+std::string unique_name() {
+    return "/quanta_pool_test_" + std::to_string(getpid()) + "_" + std::to_string(std::rand());
+}
+
+} // namespace
+
+// CREATION
+
+TEST(SharedPoolTest, CreateAnonymous) {
+    SharedPool pool = SharedPool::create_anonymous(100, 8);
+    ASSERT_TRUE(pool);
+    EXPECT_EQ(pool.block_size(), 100);
+    EXPECT_EQ(pool.block_count(), 8u);
+    EXPECT_EQ(pool.available(), 8u);
+}
+
+TEST(SharedPoolTest, InvalidParameters) {
+    EXPECT_FALSE(SharedPool::create_anonymous(0, 8));
+    EXPECT_FALSE(SharedPool::create_anonymous(64, 0));
+
+    SharedPool detached;
+    EXPECT_EQ(detached.allocate(), nullptr);
+    EXPECT_EQ(detached.recover(), 0);
+}
+
+// ALLOCATION
+
+TEST(SharedPoolTest, AllocatesDistinctAlignedBlocks) {
+    SharedPool pool = SharedPool::create_anonymous(100, 4);
+    ASSERT_TRUE(pool);
+
+    std::set<void*> blocks;
+    for (int i = 0; i < 4; ++i) {
+        void* p = pool.allocate();
+        ASSERT_NE(p, nullptr);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % 64, 0u);
+        EXPECT_EQ(pool.owner(p), getpid());
+        std::memset(p, i, 100);
+        blocks.insert(p);
+    }
+    EXPECT_EQ(blocks.size(), 4u);
+    EXPECT_EQ(pool.allocate(), nullptr);
+    EXPECT_EQ(pool.available(), 0u);
+
+    for (void* p : blocks)
+        pool.deallocate(p);
+    EXPECT_EQ(pool.available(), 4u);
+}
+
+TEST(SharedPoolTest, SizedAllocationRespectsBlockSize) {
+    SharedPool pool = SharedPool::create_anonymous(128, 2);
+    EXPECT_NE(pool.allocate(128, 8), nullptr);
+    EXPECT_EQ(pool.allocate(129, 8), nullptr);
+    EXPECT_EQ(pool.allocate(16, 128), nullptr);
+}
+
+TEST(SharedPoolTest, DoubleFreeIgnored) {
+    SharedPool pool = SharedPool::create_anonymous(64, 2);
+    void* p = pool.allocate();
+    pool.deallocate(p);
+    pool.deallocate(p);
+    EXPECT_EQ(pool.available(), 2u);
+
+    // Interior pointers are not blocks
+    void* q = pool.allocate();
+    pool.deallocate(static_cast<char*>(q) + 1);
+    EXPECT_EQ(pool.available(), 1u);
+}
+
+TEST(SharedPoolTest, HandlesRoundTrip) {
+    SharedPool pool = SharedPool::create_anonymous(64, 4);
+    void* p = pool.allocate();
+    SharedPool::Handle h = pool.handle(p);
+    EXPECT_TRUE(h);
+    EXPECT_EQ(pool.get(h), p);
+    EXPECT_EQ(pool.get(SharedPool::Handle{h.offset + 1}), nullptr);
+    EXPECT_EQ(pool.get(SharedPool::Handle{}), nullptr);
+}
+
+TEST(SharedPoolTest, ConcurrentAllocateAndFree) {
+    SharedPool pool = SharedPool::create_anonymous(64, 64);
+    ASSERT_TRUE(pool);
+
+    std::atomic<bool> corrupted{false};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < 10000; ++i) {
+                auto* p = static_cast<int*>(pool.allocate());
+                if (p == nullptr)
+                    continue;
+                *p = t;
+                if (*p != t)
+                    corrupted = true;
+                pool.deallocate(p);
+            }
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    EXPECT_FALSE(corrupted);
+    EXPECT_EQ(pool.available(), 64u);
+}
+
+// CROSS-PROCESS
+
+TEST(SharedPoolTest, FreeFromAnotherMapping) {
+    std::string name = unique_name();
+    SharedPool producer = SharedPool::create(name.c_str(), 256, 4);
+    ASSERT_TRUE(producer);
+    SharedPool consumer = SharedPool::open(name.c_str());
+    ASSERT_TRUE(consumer);
+    EXPECT_TRUE(SharedPool::unlink(name.c_str()));
+
+    char* frame = static_cast<char*>(producer.allocate());
+    std::strcpy(frame, "frame 1");
+
+    char* seen = consumer.get<char>(producer.handle(frame));
+    ASSERT_NE(seen, nullptr);
+    EXPECT_STREQ(seen, "frame 1");
+
+    consumer.deallocate(seen);
+    EXPECT_EQ(producer.available(), 4u);
+}
+
+TEST(SharedPoolTest, RecoverBlocksOfDeadProcess) {
+    SharedPool pool = SharedPool::create_anonymous(64, 8);
+    ASSERT_TRUE(pool);
+    void* mine = pool.allocate();
+
+    pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+        // Child: take three blocks and die without freeing them
+        SharedPool child = SharedPool::open_fd(pool.fd());
+        for (int i = 0; i < 3; ++i) {
+            if (child.allocate() == nullptr)
+                _exit(1);
+        }
+        _exit(0);
+    }
+
+    int status = 0;
+    ASSERT_EQ(waitpid(pid, &status, 0), pid);
+    ASSERT_TRUE(WIFEXITED(status));
+    ASSERT_EQ(WEXITSTATUS(status), 0);
+
+    EXPECT_EQ(pool.available(), 4u);
+    EXPECT_EQ(pool.recover(), 3u);
+    EXPECT_EQ(pool.available(), 7u);
+
+    // Blocks owned by live processes are left alone
+    EXPECT_EQ(pool.owner(mine), getpid());
+    EXPECT_EQ(pool.recover(), 0u);
+}
+
+TEST(SharedPoolTest, TransferProtectsHandedOffBlock) {
+    SharedPool pool = SharedPool::create_anonymous(64, 4);
+    ASSERT_TRUE(pool);
+
+    pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+        // Child: produce a frame, hand it to the parent, then die
+        SharedPool child = SharedPool::open_fd(pool.fd());
+        void* frame = child.allocate();
+        if (frame == nullptr)
+            _exit(1);
+        if (!child.transfer(frame, static_cast<int32_t>(getppid())))
+            _exit(2);
+        _exit(0);
+    }
+
+    int status = 0;
+    ASSERT_EQ(waitpid(pid, &status, 0), pid);
+    ASSERT_EQ(WEXITSTATUS(status), 0);
+
+    EXPECT_EQ(pool.recover(), 0u);
+    EXPECT_EQ(pool.available(), 3u);
+}
+
+TEST(SharedPoolTest, OwnerOfDeadProcessIsReported) {
+    SharedPool pool = SharedPool::create_anonymous(64, 4);
+    ASSERT_TRUE(pool);
+
+    int pipefd[2];
+    ASSERT_EQ(pipe(pipefd), 0);
+
+    pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+        close(pipefd[0]);
+        SharedPool child = SharedPool::open_fd(pool.fd());
+        SharedPool::Handle h = child.handle(child.allocate());
+        ssize_t written = write(pipefd[1], &h, sizeof(h));
+        _exit(written == sizeof(h) ? 0 : 1);
+    }
+
+    close(pipefd[1]);
+    SharedPool::Handle h;
+    ASSERT_EQ(read(pipefd[0], &h, sizeof(h)), static_cast<ssize_t>(sizeof(h)));
+    close(pipefd[0]);
+    int status = 0;
+    ASSERT_EQ(waitpid(pid, &status, 0), pid);
+    ASSERT_EQ(WEXITSTATUS(status), 0);
+
+    void* orphan = pool.get(h);
+    ASSERT_NE(orphan, nullptr);
+    EXPECT_EQ(pool.owner(orphan), pid);        // not yet noticed
+
+    EXPECT_EQ(pool.recover(), 1u);
+    EXPECT_EQ(pool.owner(orphan), 0);
+}
+
+TEST(SharedPoolTest, TransferToMissingProcessFails) {
+    SharedPool pool = SharedPool::create_anonymous(64, 4);
+    void* p = pool.allocate();
+
+    pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0)
+        _exit(0);
+    ASSERT_EQ(waitpid(pid, nullptr, 0), pid);
+
+    EXPECT_FALSE(pool.transfer(p, static_cast<int32_t>(pid)));
+    EXPECT_EQ(pool.owner(p), getpid());
+}
+
+// PROCESS IDENTITY
+
+TEST(SharedPoolTest, ReusedPidIsNotTheOwner) {
+    platform::ProcessIdentity self = platform::current_process_identity();
+    EXPECT_EQ(platform::process_state(self), platform::ProcessState::Alive);
+
+#if defined(__linux__)
+    // A recorded owner with our pid but another start time is an earlier
+    // process whose pid we inherited: it is dead, though the pid runs
+    ASSERT_NE(self.start_time, 0u);
+    platform::ProcessIdentity earlier = self;
+    earlier.start_time -= 1;
+    EXPECT_EQ(platform::process_state(earlier), platform::ProcessState::Dead);
+
+    // A pid from another pid namespace cannot be judged from here
+    platform::ProcessIdentity foreign = self;
+    foreign.pid_namespace += 1;
+    EXPECT_EQ(platform::process_state(foreign), platform::ProcessState::Unknown);
+#endif
+}
+
+TEST(SharedPoolTest, ProcessTableSurvivesManyShortLivedProcesses) {
+    SharedPool pool = SharedPool::create_anonymous(64, 4);
+    ASSERT_TRUE(pool);
+
+    // More children than table entries: retired entries must be reused
+    for (uint32_t i = 0; i < SharedPool::max_processes + 16; ++i) {
+        pid_t pid = fork();
+        ASSERT_GE(pid, 0);
+        if (pid == 0) {
+            SharedPool child = SharedPool::open_fd(pool.fd());
+            _exit(child.allocate() != nullptr ? 0 : 1);
+        }
+        int status = 0;
+        ASSERT_EQ(waitpid(pid, &status, 0), pid);
+        ASSERT_EQ(WEXITSTATUS(status), 0);
+        ASSERT_EQ(pool.recover(), 1u);
+    }
+    EXPECT_EQ(pool.available(), 4u);
+}
+
+TEST(SharedPoolTest, RegistersOnceTableHasRoomAgain) {
+    SharedPool pool = SharedPool::create_anonymous(64, SharedPool::max_processes + 8);
+    ASSERT_TRUE(pool);
+
+    int ready[2], release[2], go[2];
+    ASSERT_EQ(pipe(ready), 0);
+    ASSERT_EQ(pipe(release), 0);
+    ASSERT_EQ(pipe(go), 0);
+
+    // Fill the process table with children that hold a block until released
+    std::vector<pid_t> holders;
+    for (uint32_t i = 0; i < SharedPool::max_processes; ++i) {
+        pid_t pid = fork();
+        ASSERT_GE(pid, 0);
+        if (pid == 0) {
+            close(release[1]);
+            SharedPool child = SharedPool::open_fd(pool.fd());
+            char byte = child.allocate() != nullptr ? 1 : 0;
+            (void)!write(ready[1], &byte, 1);
+            (void)!read(release[0], &byte, 1);
+            _exit(0);
+        }
+        holders.push_back(pid);
+    }
+    for (uint32_t i = 0; i < SharedPool::max_processes; ++i) {
+        char byte = 0;
+        ASSERT_EQ(read(ready[0], &byte, 1), 1);
+        ASSERT_EQ(byte, 1);
+    }
+
+    // This child allocates once with the table full, then again after it drains
+    pid_t late = fork();
+    ASSERT_GE(late, 0);
+    if (late == 0) {
+        close(release[1]);
+        SharedPool child = SharedPool::open_fd(pool.fd());
+        char byte = child.allocate() != nullptr ? 1 : 0;
+        (void)!write(ready[1], &byte, 1);
+        (void)!read(go[0], &byte, 1);
+        _exit(child.allocate() != nullptr ? 0 : 1);
+    }
+    char byte = 0;
+    ASSERT_EQ(read(ready[0], &byte, 1), 1);
+    ASSERT_EQ(byte, 1);
+
+    close(release[1]);
+    for (pid_t pid : holders)
+        ASSERT_EQ(waitpid(pid, nullptr, 0), pid);
+    EXPECT_EQ(pool.recover(), SharedPool::max_processes);
+
+    ASSERT_EQ(write(go[1], &byte, 1), 1);
+    int status = 0;
+    ASSERT_EQ(waitpid(late, &status, 0), late);
+    ASSERT_EQ(WEXITSTATUS(status), 0);
+
+    // The first block was untracked and stays lost; the second one is recovered
+    EXPECT_EQ(pool.recover(), 1u);
+
+    for (int fd : {ready[0], ready[1], release[0], go[0], go[1]})
+        close(fd);
+}
+#endif
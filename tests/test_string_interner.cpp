@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+#include "quanta/StringInterner.hpp"
+
+#include <string>
+
+using namespace quanta;
+
+// INTERNING
+
+TEST(StringInternerTest, SameStringSameId) {
+    Arena arena(1024);
+    StringInterner interner(arena);
+
+    auto a = interner.intern("host");
+    auto b = interner.intern(std::string("host"));
+    EXPECT_NE(a, StringInterner::invalid_id);
+    EXPECT_EQ(a, b);
+    EXPECT_EQ(interner.size(), 1);
+}
+
+TEST(StringInternerTest, DistinctStringsDistinctIds) {
+    Arena arena(1024);
+    StringInterner interner(arena);
+
+    auto a = interner.intern("host");
+    auto b = interner.intern("region");
+    EXPECT_NE(a, b);
+    EXPECT_EQ(interner.view(a), "host");
+    EXPECT_EQ(interner.view(b), "region");
+}
+
+TEST(StringInternerTest, BytesAreCopiedOnce) {
+    Arena arena(1024);
+    StringInterner interner(arena);
+
+    interner.intern("label");
+    size_t used = arena.used();
+    interner.intern("label");
+    EXPECT_EQ(arena.used(), used);
+
+    std::string_view v = interner.intern_view("label");
+    EXPECT_TRUE(arena.owns(const_cast<char*>(v.data())));
+}
+
+TEST(StringInternerTest, EmptyString) {
+    Arena arena(64);
+    StringInterner interner(arena);
+
+    auto id = interner.intern("");
+    EXPECT_NE(id, StringInterner::invalid_id);
+    EXPECT_EQ(interner.intern(""), id);
+    EXPECT_TRUE(interner.view(id).empty());
+    EXPECT_EQ(arena.used(), 0);
+}
+
+// LOOKUP
+
+TEST(StringInternerTest, FindDoesNotInsert) {
+    Arena arena(1024);
+    StringInterner interner(arena);
+
+    EXPECT_EQ(interner.find("missing"), StringInterner::invalid_id);
+    EXPECT_EQ(interner.size(), 0);
+
+    auto id = interner.intern("present");
+    EXPECT_EQ(interner.find("present"), id);
+}
+
+TEST(StringInternerTest, InvalidIdViewIsEmpty) {
+    Arena arena(64);
+    StringInterner interner(arena);
+
+    EXPECT_TRUE(interner.view(StringInterner::invalid_id).empty());
+    EXPECT_TRUE(interner.view(3).empty());
+}
+
+// OUT OF MEMORY
+
+TEST(StringInternerTest, ArenaExhausted) {
+    Arena arena(8);
+    StringInterner interner(arena);
+
+    EXPECT_NE(interner.intern("12345678"), StringInterner::invalid_id);
+    EXPECT_EQ(interner.intern("overflow"), StringInterner::invalid_id);
+    EXPECT_EQ(interner.size(), 1);
+    EXPECT_EQ(interner.find("overflow"), StringInterner::invalid_id);
+}
+
+// GROWTH AND CLEAR
+
+TEST(StringInternerTest, ManyStringsSurviveRehash) {
+    Arena arena(1024 * 1024);
+    StringInterner interner(arena);
+
+    for (int i = 0; i < 10000; ++i) {
+        auto id = interner.intern("label_" + std::to_string(i));
+        ASSERT_EQ(id, static_cast<StringInterner::Id>(i));
+    }
+
+    for (int i = 0; i < 10000; ++i) {
+        std::string s = "label_" + std::to_string(i);
+        EXPECT_EQ(interner.find(s), static_cast<StringInterner::Id>(i));
+        EXPECT_EQ(interner.view(i), s);
+    }
+}
+
+TEST(StringInternerTest, ClearWithArenaReset) {
+    Arena arena(1024);
+    StringInterner interner(arena);
+
+    interner.intern("a");
+    interner.intern("b");
+
+    interner.clear();
+    arena.reset();
+
+    EXPECT_EQ(interner.size(), 0);
+    EXPECT_EQ(interner.find("a"), StringInterner::invalid_id);
+    EXPECT_EQ(interner.intern("b"), 0u);
+}
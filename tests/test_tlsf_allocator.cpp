@@ -0,0 +1,167 @@
+#include <gtest/gtest.h>
+#include "quanta/TlsfAllocator.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace quanta;
+
+// CONSTRUCTION
+
+TEST(TlsfAllocatorTest, ConstructFromArena) {
+    Arena arena(1 << 16);
+    TlsfAllocator tlsf(arena, 1 << 16);
+
+    EXPECT_GT(tlsf.capacity(), 0);
+    EXPECT_LE(tlsf.capacity(), size_t{1} << 16);
+    EXPECT_EQ(tlsf.used(), 0);
+}
+
+TEST(TlsfAllocatorTest, RegionTooSmall) {
+    char buffer[16];
+    TlsfAllocator tlsf(buffer, sizeof(buffer));
+
+    EXPECT_EQ(tlsf.capacity(), 0);
+    EXPECT_EQ(tlsf.allocate(8), nullptr);
+}
+
+TEST(TlsfAllocatorTest, EmptyAllocator) {
+    TlsfAllocator tlsf;
+    EXPECT_EQ(tlsf.allocate(8), nullptr);
+}
+
+// ALLOCATION
+
+TEST(TlsfAllocatorTest, BasicAllocation) {
+    Arena arena(1 << 16);
+    TlsfAllocator tlsf(arena, 1 << 16);
+
+    void* a = tlsf.allocate(100);
+    void* b = tlsf.allocate(200);
+    ASSERT_NE(a, nullptr);
+    ASSERT_NE(b, nullptr);
+    EXPECT_NE(a, b);
+    EXPECT_TRUE(tlsf.owns(a));
+    EXPECT_TRUE(tlsf.owns(b));
+    EXPECT_GE(TlsfAllocator::usable_size(a), 100);
+    EXPECT_GE(tlsf.used(), 300);
+
+    std::memset(a, 0xAA, 100);
+    std::memset(b, 0xBB, 200);
+    EXPECT_EQ(static_cast<unsigned char*>(a)[99], 0xAA);
+}
+
+TEST(TlsfAllocatorTest, InvalidRequests) {
+    Arena arena(1 << 16);
+    TlsfAllocator tlsf(arena, 1 << 16);
+
+    EXPECT_EQ(tlsf.allocate(0), nullptr);
+    EXPECT_EQ(tlsf.allocate(8, 3), nullptr);
+    EXPECT_EQ(tlsf.allocate(1 << 17), nullptr);
+}
+
+TEST(TlsfAllocatorTest, Alignment) {
+    Arena arena(1 << 20);
+    TlsfAllocator tlsf(arena, 1 << 20);
+
+    tlsf.allocate(3);
+    for (size_t align : {8, 16, 32, 64, 256, 4096}) {
+        void* p = tlsf.allocate(24, align);
+        ASSERT_NE(p, nullptr);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % align, 0);
+    }
+}
+
+TEST(TlsfAllocatorTest, ExhaustAndRecover) {
+    Arena arena(1 << 16);
+    TlsfAllocator tlsf(arena, 1 << 16);
+
+    std::vector<void*> blocks;
+    while (void* p = tlsf.allocate(1000))
+        blocks.push_back(p);
+    EXPECT_GT(blocks.size(), 50);
+
+    for (void* p : blocks)
+        tlsf.deallocate(p);
+    EXPECT_EQ(tlsf.used(), 0);
+
+    // Everything coalesced back into one block
+    EXPECT_NE(tlsf.allocate(tlsf.capacity() / 2), nullptr);
+}
+
+// FREE AND COALESCE
+
+TEST(TlsfAllocatorTest, CoalesceWithNeighbours) {
+    Arena arena(1 << 16);
+    TlsfAllocator tlsf(arena, 8192);
+
+    void* a = tlsf.allocate(2000);
+    void* b = tlsf.allocate(2000);
+    void* c = tlsf.allocate(2000);
+    ASSERT_NE(c, nullptr);
+
+    tlsf.deallocate(a);
+    tlsf.deallocate(c);
+    tlsf.deallocate(b);
+
+    EXPECT_NE(tlsf.allocate(6000), nullptr);
+}
+
+TEST(TlsfAllocatorTest, FreedMemoryIsReused) {
+    Arena arena(1 << 16);
+    TlsfAllocator tlsf(arena, 1 << 16);
+
+    void* a = tlsf.allocate(512);
+    tlsf.deallocate(a);
+    EXPECT_EQ(tlsf.allocate(512), a);
+}
+
+TEST(TlsfAllocatorTest, NullIgnored) {
+    Arena arena(1 << 16);
+    TlsfAllocator tlsf(arena, 1 << 16);
+
+    tlsf.deallocate(nullptr);
+    EXPECT_EQ(tlsf.used(), 0);
+}
+
+// STRESS
+
+TEST(TlsfAllocatorTest, RandomAllocFreeKeepsDataIntact) {
+    Arena arena(1 << 22);
+    TlsfAllocator tlsf(arena, 1 << 22);
+    std::mt19937 rng(7);
+
+    struct Live {
+        unsigned char* p;
+        size_t size;
+        unsigned char tag;
+    };
+    std::vector<Live> live;
+
+    for (int i = 0; i < 50000; ++i) {
+        if (live.empty() || rng() % 2 == 0) {
+            size_t size = 1 + rng() % 5000;
+            size_t align = size_t{8} << (rng() % 4);
+            auto* p = static_cast<unsigned char*>(tlsf.allocate(size, align));
+            if (p == nullptr)
+                continue;
+            ASSERT_EQ(reinterpret_cast<uintptr_t>(p) % align, 0);
+            auto tag = static_cast<unsigned char>(i);
+            std::memset(p, tag, size);
+            live.push_back({p, size, tag});
+        } else {
+            size_t k = rng() % live.size();
+            Live& l = live[k];
+            ASSERT_TRUE(std::all_of(l.p, l.p + l.size, [&](unsigned char c) { return c == l.tag; }));
+            tlsf.deallocate(l.p);
+            live[k] = live.back();
+            live.pop_back();
+        }
+    }
+
+    for (Live& l : live)
+        tlsf.deallocate(l.p);
+    EXPECT_EQ(tlsf.used(), 0);
+}
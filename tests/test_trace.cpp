@@ -0,0 +1,272 @@
+#include <gtest/gtest.h>
+#include "quanta/Arena.hpp"
+#include "quanta/TlsfAllocator.hpp"
+#include "quanta/Trace.hpp"
+
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace quanta;
+
+namespace {
+
+std::string temp_path() {
+    return testing::TempDir() + "arenax_trace_" + std::to_string(std::rand()) + ".bin";
+}
+
+} // namespace
+
+// RECORDING
+
+TEST(TraceTest, RecordsAreCompact) {
+    EXPECT_EQ(sizeof(TraceRecord), 32);
+}
+
+TEST(TraceTest, RecordAndReadBack) {
+    std::string path = temp_path();
+    {
+        Tracer tracer(path.c_str());
+        ASSERT_TRUE(tracer);
+
+        TracingAllocator<Mallocator> alloc(Mallocator(), tracer);
+        void* a = alloc.allocate(100, 8);
+        void* b = alloc.allocate(24, 16);
+        alloc.deallocate(a, 100);
+        alloc.deallocate(b, 24);
+    }
+
+    std::vector<TraceRecord> records;
+    ASSERT_TRUE(read_trace(path.c_str(), records));
+    ASSERT_EQ(records.size(), 4u);
+
+    EXPECT_EQ(records[0].op, TraceRecord::Op::Allocate);
+    EXPECT_EQ(records[0].size, 100u);
+    EXPECT_EQ(records[0].alignment(), 8u);
+    EXPECT_EQ(records[1].alignment(), 16u);
+    EXPECT_EQ(records[2].op, TraceRecord::Op::Deallocate);
+    EXPECT_EQ(records[2].address, records[0].address);
+    EXPECT_EQ(records[3].address, records[1].address);
+    EXPECT_LE(records[0].timestamp, records[3].timestamp);
+
+    std::remove(path.c_str());
+}
+
+TEST(TraceTest, FailuresAndResetsRecorded) {
+    std::string path = temp_path();
+    {
+        Tracer tracer(path.c_str());
+        TracingAllocator<Arena> alloc(Arena(64), tracer);
+        EXPECT_EQ(alloc.allocate(128, 8), nullptr);
+        EXPECT_NE(alloc.allocate(32, 8), nullptr);
+        alloc.reset();
+    }
+
+    std::vector<TraceRecord> records;
+    ASSERT_TRUE(read_trace(path.c_str(), records));
+    ASSERT_EQ(records.size(), 3u);
+    EXPECT_EQ(records[0].address, 0u);
+    EXPECT_EQ(records[2].op, TraceRecord::Op::Reset);
+
+    std::remove(path.c_str());
+}
+
+TEST(TraceTest, SmallBuffersFlushWhenFull) {
+    std::string path = temp_path();
+    Tracer tracer(path.c_str(), 4);
+    for (int i = 0; i < 10; ++i)
+        tracer.record(TraceRecord::Op::Allocate, &i, 1);
+
+    // Eight records have reached the file; the last two are still buffered
+    std::vector<TraceRecord> records;
+    tracer.flush();
+    ASSERT_TRUE(read_trace(path.c_str(), records));
+    EXPECT_EQ(records.size(), 10u);
+    EXPECT_EQ(tracer.dropped(), 0u);
+
+    std::remove(path.c_str());
+}
+
+TEST(TraceTest, ThreadsGetTheirOwnBuffers) {
+    std::string path = temp_path();
+    {
+        Tracer tracer(path.c_str(), 64);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&tracer] {
+                TracingAllocator<Mallocator> alloc(Mallocator(), tracer);
+                for (int i = 0; i < 1000; ++i)
+                    alloc.deallocate(alloc.allocate(16, 8), 16);
+            });
+        }
+        for (auto& thread : threads)
+            thread.join();
+    }
+
+    std::vector<TraceRecord> records;
+    ASSERT_TRUE(read_trace(path.c_str(), records));
+    EXPECT_EQ(records.size(), 8000u);
+
+    std::vector<size_t> per_thread(4);
+    for (size_t i = 0; i < records.size(); ++i) {
+        ASSERT_LT(records[i].thread, 4u);
+        ++per_thread[records[i].thread];
+        if (i > 0) {
+            EXPECT_LE(records[i - 1].timestamp, records[i].timestamp);
+        }
+    }
+    for (size_t count : per_thread)
+        EXPECT_EQ(count, 2000u);
+
+    std::remove(path.c_str());
+}
+
+TEST(TraceTest, AlternatingTracersKeepTheirBuffers) {
+    std::string path_a = temp_path() + "a";
+    std::string path_b = temp_path() + "b";
+    {
+        Tracer a(path_a.c_str(), 1024);
+        Tracer b(path_b.c_str(), 1024);
+
+        // Switching tracers must neither flush nor renumber the thread
+        for (int i = 0; i < 100; ++i) {
+            a.record(TraceRecord::Op::Allocate, &a, 8);
+            b.record(TraceRecord::Op::Allocate, &b, 16);
+        }
+        EXPECT_EQ(a.dropped(), 0);
+        EXPECT_EQ(b.dropped(), 0);
+    }
+
+    std::vector<TraceRecord> records;
+    ASSERT_TRUE(read_trace(path_a.c_str(), records));
+    ASSERT_EQ(records.size(), 100u);
+    for (const TraceRecord& r : records)
+        EXPECT_EQ(r.thread, 0u);
+
+    ASSERT_TRUE(read_trace(path_b.c_str(), records));
+    ASSERT_EQ(records.size(), 100u);
+    for (const TraceRecord& r : records)
+        EXPECT_EQ(r.thread, 0u);
+
+    std::remove(path_a.c_str());
+    std::remove(path_b.c_str());
+}
+
+TEST(TraceTest, ThreadOutlivesTracer) {
+    std::string first = temp_path();
+    std::string second = temp_path() + "2";
+    {
+        Tracer tracer(first.c_str());
+        tracer.record(TraceRecord::Op::Allocate, &tracer, 8);
+    }
+    {
+        // The buffer left by the destroyed tracer is reused, not written to the old file
+        Tracer tracer(second.c_str());
+        tracer.record(TraceRecord::Op::Allocate, &tracer, 8);
+    }
+
+    std::vector<TraceRecord> records;
+    ASSERT_TRUE(read_trace(first.c_str(), records));
+    EXPECT_EQ(records.size(), 1u);
+    ASSERT_TRUE(read_trace(second.c_str(), records));
+    EXPECT_EQ(records.size(), 1u);
+
+    std::remove(first.c_str());
+    std::remove(second.c_str());
+}
+
+TEST(TraceTest, ReadRejectsOtherFiles) {
+    std::vector<TraceRecord> records;
+    EXPECT_FALSE(read_trace("/nonexistent/trace", records));
+}
+
+// REPLAY
+
+TEST(TraceTest, ReplayIntoOtherAllocators) {
+    std::string path = temp_path();
+    {
+        Tracer tracer(path.c_str());
+        TracingAllocator<Mallocator> alloc(Mallocator(), tracer);
+        std::vector<void*> live;
+        for (int i = 0; i < 50; ++i)
+            live.push_back(alloc.allocate(64, 8));
+        for (void* p : live)
+            alloc.deallocate(p, 64);
+    }
+
+    std::vector<TraceRecord> records;
+    ASSERT_TRUE(read_trace(path.c_str(), records));
+
+    StatsAllocator<Mallocator> malloc_stats;
+    ReplayResult r = replay(records, malloc_stats);
+    EXPECT_EQ(r.allocations, 50u);
+    EXPECT_EQ(r.deallocations, 50u);
+    EXPECT_EQ(r.failures, 0u);
+    EXPECT_EQ(r.peak_live_bytes, 50u * 64);
+    EXPECT_EQ(malloc_stats.stats().bytes_live, 0u);
+
+    // A small arena runs out where malloc did not
+    Arena arena(1024);
+    ReplayResult small = replay(records, arena);
+    EXPECT_EQ(small.allocations, 16u);
+    EXPECT_EQ(small.failures, 34u);
+
+    std::remove(path.c_str());
+}
+
+TEST(TraceTest, ReplayResets) {
+    std::vector<TraceRecord> records(3);
+    records[0] = TraceRecord{0, 1, 100, 0, TraceRecord::Op::Allocate, 3, 0};
+    records[1] = TraceRecord{1, 0, 0, 0, TraceRecord::Op::Reset, 0, 0};
+    records[2] = TraceRecord{2, 1, 100, 0, TraceRecord::Op::Deallocate, 0, 0};
+
+    Arena arena(1024);
+    ReplayResult r = replay(records, arena);
+    EXPECT_EQ(r.resets, 1u);
+    EXPECT_EQ(r.skipped, 1u);
+    EXPECT_EQ(arena.used(), 0u);
+
+    // Allocators without reset() free every live block instead
+    StatsAllocator<Mallocator> malloc_stats;
+    r = replay(records, malloc_stats);
+    EXPECT_EQ(r.resets, 1u);
+    EXPECT_EQ(r.deallocations, 1u);
+    EXPECT_EQ(r.skipped, 1u);
+    EXPECT_EQ(malloc_stats.stats().bytes_live, 0u);
+}
+
+TEST(TraceTest, ReplayResetsIntoAllocatorWithoutReset) {
+    // An arena reused through resets: the same addresses come back every round
+    std::vector<TraceRecord> records;
+    uint64_t time = 0;
+    for (int round = 0; round < 1000; ++round) {
+        for (uint64_t i = 0; i < 100; ++i)
+            records.push_back(TraceRecord{time++, 0x10000 + i * 1024, 1024, 0, TraceRecord::Op::Allocate, 3, 0});
+        records.push_back(TraceRecord{time++, 0, 0, 0, TraceRecord::Op::Reset, 0, 0});
+    }
+
+    Arena backing((8 << 20) + (1 << 20));
+    TlsfAllocator tlsf(backing, 8 << 20);
+    ReplayResult r = replay(records, tlsf);
+    EXPECT_EQ(r.failures, 0u);
+    EXPECT_EQ(r.allocations, 100000u);
+    EXPECT_EQ(r.deallocations, 100000u);
+    EXPECT_EQ(r.resets, 1000u);
+    EXPECT_EQ(r.peak_live_bytes, 100u * 1024);
+}
+
+TEST(TraceTest, ReplayFreesBlockAtReusedAddress) {
+    // The free of the first block at address 1 was never traced
+    std::vector<TraceRecord> records(3);
+    records[0] = TraceRecord{0, 1, 100, 0, TraceRecord::Op::Allocate, 3, 0};
+    records[1] = TraceRecord{1, 1, 200, 0, TraceRecord::Op::Allocate, 3, 0};
+    records[2] = TraceRecord{2, 1, 200, 0, TraceRecord::Op::Deallocate, 0, 0};
+
+    StatsAllocator<Mallocator> malloc_stats;
+    ReplayResult r = replay(records, malloc_stats);
+    EXPECT_EQ(r.allocations, 2u);
+    EXPECT_EQ(r.deallocations, 2u);
+    EXPECT_EQ(r.peak_live_bytes, 200u);
+    EXPECT_EQ(malloc_stats.stats().bytes_live, 0u);
+}
@@ -0,0 +1,85 @@
+// Replays an allocation trace recorded with quanta::Tracer against every
+// allocator in the library (and malloc), one after the other.
+//
+//   arenax_replay <trace file> [memory MiB, default 256]
+
+#include "quanta/Arena.hpp"
+#include "quanta/BuddyAllocator.hpp"
+#include "quanta/Composable.hpp"
+#include "quanta/GrowingArena.hpp"
+#include "quanta/TlsfAllocator.hpp"
+#include "quanta/Trace.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace quanta;
+
+namespace {
+
+// Reset-capable view of a GrowingArena (frees are no-ops)
+struct GrowingAdapter {
+    GrowingArena& arena;
+
+    void* allocate(size_t size, size_t alignment) noexcept { return arena.allocate(size, alignment); }
+    void deallocate(void*, size_t) noexcept {}
+    void reset() noexcept { arena.reset(); }
+};
+
+template<typename A>
+void run(const char* name, const std::vector<TraceRecord>& records, A& allocator) {
+    ReplayResult r = replay(records, allocator);
+    double ns_per_op = r.operations() > 0
+                           ? static_cast<double>(r.elapsed.count()) / static_cast<double>(r.operations())
+                           : 0.0;
+
+    std::printf("%-10s %12zu %10zu %12zu %8zu %14zu %10.1f\n", name, r.allocations, r.failures,
+                r.deallocations, r.resets, r.peak_live_bytes, ns_per_op);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: %s <trace file> [memory MiB]\n", argv[0]);
+        return 2;
+    }
+
+    std::vector<TraceRecord> records;
+    if (!read_trace(argv[1], records)) {
+        std::fprintf(stderr, "%s: cannot read trace %s\n", argv[0], argv[1]);
+        return 1;
+    }
+
+    size_t memory = static_cast<size_t>(argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 256) << 20;
+    std::printf("%zu records, %zu MiB per allocator\n\n", records.size(), memory >> 20);
+    std::printf("%-10s %12s %10s %12s %8s %14s %10s\n", "allocator", "allocations", "failures",
+                "frees", "resets", "peak live B", "ns/op");
+
+    {
+        Mallocator malloc_alloc;
+        run("malloc", records, malloc_alloc);
+    }
+    {
+        Arena arena(memory);
+        run("arena", records, arena);
+    }
+    {
+        GrowingArena growing(1 << 20);
+        GrowingAdapter adapter{growing};
+        run("growing", records, adapter);
+    }
+    {
+        Arena backing(memory + (1 << 20));
+        TlsfAllocator tlsf(backing, memory);
+        run("tlsf", records, tlsf);
+    }
+    {
+        Arena backing(2 * memory);
+        BuddyAllocator buddy(backing, memory, 16);
+        run("buddy", records, buddy);
+    }
+
+    return 0;
+}